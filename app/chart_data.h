@@ -0,0 +1,264 @@
+/*********************************************************************
+* ChartData class                                                    *
+*                                                                    *
+* Series loaded by the visualizer app. The page only receives the    *
+* points of the range being shown, reduced to the width of the plot  *
+* with the level of detail pyramids of the series.                   *
+*                                                                    *
+* Version: 1.1                                                       *
+* Date:    16-10-2026                                                *
+* Author:  Dan Machado                                               *
+**********************************************************************/
+#ifndef CHART_DATA_H
+#define CHART_DATA_H
+
+#include <cstdio>
+#include <iomanip>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <time_profiler/dataset_file.h>
+#include <time_profiler/decimation.h>
+#include <time_profiler/lod_pyramid.h>
+
+//====================================================================
+
+/*
+ * Base64 encoding, decoded in the page by decodeBase64().
+ *
+ * */
+inline std::string encodeBase64(const void* data, std::size_t size)
+{
+	static const char table[]="ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+	const unsigned char* bytes=static_cast<const unsigned char*>(data);
+	std::string encoded;
+	encoded.reserve((size+2)/3*4);
+
+	std::size_t i=0;
+	for(; i+2<size; i+=3){
+		unsigned triple=(bytes[i]<<16)|(bytes[i+1]<<8)|bytes[i+2];
+		encoded.push_back(table[(triple>>18)&0x3F]);
+		encoded.push_back(table[(triple>>12)&0x3F]);
+		encoded.push_back(table[(triple>>6)&0x3F]);
+		encoded.push_back(table[triple&0x3F]);
+	}
+
+	if(i<size){
+		unsigned triple=bytes[i]<<16;
+		if(i+1<size){
+			triple|=bytes[i+1]<<8;
+		}
+		encoded.push_back(table[(triple>>18)&0x3F]);
+		encoded.push_back(table[(triple>>12)&0x3F]);
+		encoded.push_back(i+1<size ? table[(triple>>6)&0x3F] : '=');
+		encoded.push_back('=');
+	}
+	return encoded;
+}
+
+//====================================================================
+
+class ChartData
+{
+	public:
+		/*
+		 * Split labelled series, as splitLabels() does in
+		 * lines_setup.min.js, and set the y title. Throughput series keep
+		 * their elapsed times and work, they are turned into rates when
+		 * viewed so a bucket is the rate of all its samples. Meant to run
+		 * on the loader thread.
+		 *
+		 * */
+		static void prepare(tprofiler::DataSet& dataSet)
+		{
+			std::vector<tprofiler::Series> series;
+			for(tprofiler::Series& s : dataSet.series){
+				if(s.labels.empty() || s.labelNames.empty()){
+					series.push_back(std::move(s));
+					continue;
+				}
+
+				for(std::size_t n=0; n<s.labelNames.size(); n++){
+					tprofiler::Series split;
+					for(std::size_t i=0; i<s.labels.size() && i<s.data.size(); i++){
+						if(s.labels[i]==n){
+							split.data.push_back(s.data[i]);
+							if(i<s.work.size()){
+								split.work.push_back(s.work[i]);
+							}
+						}
+					}
+					if(split.data.empty()){
+						continue;
+					}
+					split.name=s.name+(s.labelNames[n].empty() ? "" : " ["+s.labelNames[n]+"]");
+					split.colour=n==0 ? s.colour : tprofiler::lighterColour(s.colour, std::min(0.85, 0.15*n));
+					series.push_back(std::move(split));
+				}
+			}
+			dataSet.series=std::move(series);
+
+			for(tprofiler::Series& s : dataSet.series){
+				if(dataSet.workUnits.empty()){
+					s.work.clear();
+				}
+				else{
+					s.work.resize(s.data.size(), 0);
+				}
+			}
+
+			if(dataSet.yTitle.empty()){
+				dataSet.yTitle=defaultYTitle(dataSet);
+			}
+		}
+
+		static std::string defaultYTitle(const tprofiler::DataSet& dataSet)
+		{
+			if(!dataSet.workUnits.empty()){
+				return "Throughput ("+dataSet.workUnits+"/"+dataSet.timeUnits+")";
+			}
+			return "Elapsed time ("+dataSet.timeUnits+")";
+		}
+
+		/*
+		 * @param pyramids pyramids of the series of the dataset
+		 * */
+		void add(tprofiler::DataSet&& dataSet, std::vector<tprofiler::LodPyramid>&& pyramids)
+		{
+			if(pyramids.size()!=dataSet.series.size()){
+				pyramids=tprofiler::buildPyramids(dataSet.series);
+			}
+			for(tprofiler::LodPyramid& pyramid : pyramids){
+				m_pyramids.push_back(std::move(pyramid));
+			}
+
+			for(tprofiler::Series& s : dataSet.series){
+				for(const tprofiler::Series& other : m_series){
+					if(other.colour==s.colour){
+						char colour[8];
+						std::snprintf(colour, sizeof(colour), "#%06x", static_cast<unsigned>(m_random()&0xFFFFFF));
+						s.colour=colour;
+						break;
+					}
+				}
+				m_series.push_back(std::move(s));
+			}
+			m_yTitle=dataSet.yTitle;
+
+			if(!dataSet.x.empty()){
+				m_xLabels.clear();
+				std::ostringstream label;
+				label<<std::setprecision(15);
+				for(std::size_t i=0; i<dataSet.x.size(); i++){
+					if(i<dataSet.xLabels.size()){
+						m_xLabels.push_back(dataSet.xLabels[i]);
+						continue;
+					}
+					label.str("");
+					label<<dataSet.x[i];
+					m_xLabels.push_back(label.str());
+				}
+				m_xTitle=dataSet.xTitle.empty() ? "Samples" : dataSet.xTitle;
+			}
+		}
+
+		void clear()
+		{
+			m_series.clear();
+			m_pyramids.clear();
+			m_xLabels.clear();
+			m_xTitle="Samples";
+			m_yTitle.clear();
+		}
+
+		bool empty() const
+		{
+			return m_series.empty();
+		}
+
+		/*
+		 * Samples in the longest series.
+		 *
+		 * */
+		std::size_t samples() const
+		{
+			std::size_t longest=0;
+			for(const tprofiler::Series& s : m_series){
+				longest=std::max(longest, s.data.size());
+			}
+			return longest;
+		}
+
+		void setColour(std::size_t series, const std::string& colour)
+		{
+			if(series<m_series.size()){
+				m_series[series].colour=colour;
+			}
+		}
+
+		/*
+		 * Script handing the samples [first, last) to nativeLoader.view(),
+		 * reduced to pixels buckets, in time proportional to pixels.
+		 *
+		 * */
+		std::string viewScript(std::size_t first, std::size_t last, std::size_t pixels) const
+		{
+			std::size_t total=samples();
+			last=std::min(last, total);
+			tprofiler::MinMaxDecimator decimator(first, last, pixels);
+			std::vector<std::vector<double>> points=tprofiler::decimateSeries(decimator, m_series, m_pyramids);
+
+			std::ostringstream script;
+			script<<"nativeLoader.view({\"dataSet\": [";
+			for(std::size_t i=0; i<m_series.size(); i++){
+				script<<(i>0 ? ", " : "")<<"{\"name\": ";
+				tprofiler::writeJsonString(script, m_series[i].name);
+				script<<", \"color\": ";
+				tprofiler::writeJsonString(script, m_series[i].colour);
+				script<<", \"data\": \""<<encodeBase64(points[i].data(), points[i].size()*sizeof(double))<<"\"}";
+			}
+
+			// every point is labelled with the first sample of its bucket
+			std::ostringstream start;
+			script<<"], \"labels\": [";
+			for(std::size_t bucket=0; bucket<decimator.buckets(); bucket++){
+				std::size_t sample=decimator.bucketStart(bucket);
+				for(std::size_t k=0; k<decimator.pointsPerBucket(); k++){
+					bool separator=bucket>0 || k>0;
+					script<<(separator ? ", " : "");
+					tprofiler::writeJsonString(script, label(sample));
+					start<<(separator ? ", " : "")<<sample;
+				}
+			}
+			script<<"], \"start\": ["<<start.str()<<"]";
+			script<<", \"first\": "<<decimator.first()<<", \"last\": "<<decimator.last()<<", \"total\": "<<total;
+			script<<", \"xTitle\": ";
+			tprofiler::writeJsonString(script, m_xTitle);
+			script<<", \"yTitle\": ";
+			tprofiler::writeJsonString(script, m_yTitle);
+			script<<"});";
+			return script.str();
+		}
+
+	private:
+		std::vector<tprofiler::Series> m_series{};
+		std::vector<tprofiler::LodPyramid> m_pyramids{}; // of m_series
+		std::vector<std::string> m_xLabels{};
+		std::string m_xTitle{"Samples"};
+		std::string m_yTitle{};
+		std::minstd_rand m_random{};
+
+		std::string label(std::size_t sample) const
+		{
+			if(sample<m_xLabels.size()){
+				return m_xLabels[sample];
+			}
+			return "s"+std::to_string(sample+1);
+		}
+};
+
+//====================================================================
+
+#endif
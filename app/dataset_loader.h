@@ -0,0 +1,237 @@
+/*********************************************************************
+* DataSetLoader class                                                *
+*                                                                    *
+* Parses dataset files on a worker thread for the visualizer and     *
+* prepares them for ChartData, with the level of detail pyramids of  *
+* their series. Reports progress and can be cancelled.               *
+*                                                                    *
+* Version: 1.4                                                       *
+* Date:    16-10-2026                                                *
+* Author:  Dan Machado                                               *
+**********************************************************************/
+#ifndef DATASET_LOADER_H
+#define DATASET_LOADER_H
+
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <time_profiler/dataset_file.h>
+#include <time_profiler/lod_pyramid.h>
+
+#include "chart_data.h"
+
+//====================================================================
+
+/*
+ * Loads files one after the other on a worker thread. The callbacks
+ * are called from the worker thread.
+ *
+ * */
+class DataSetLoader
+{
+	public:
+		// fraction in [0, 1] of the file being parsed
+		using Progress=std::function<void(double fraction, const std::string& file)>;
+
+		// dataset of the file and pyramids of its series ready for
+		// ChartData::add(), or the error message if it failed; a
+		// message with a dataset is a warning, the cache not written
+		using Loaded=std::function<void(tprofiler::DataSet&& dataSet, std::vector<tprofiler::LodPyramid>&& pyramids, const std::string& error)>;
+
+		// all files done or cancelled
+		using Finished=std::function<void(bool cancelled)>;
+
+		// pyramids of files with at least this many samples are cached
+		// in a ".lod" file next to them, see cachePyramids()
+		static const std::size_t CACHE_SAMPLES=1<<22;
+
+		DataSetLoader()=default;
+		DataSetLoader(const DataSetLoader&)=delete;
+		DataSetLoader& operator=(const DataSetLoader&)=delete;
+
+		~DataSetLoader()
+		{
+			cancel();
+			join();
+		}
+
+		/*
+		 * @return false if a previous load is still running
+		 * */
+		bool start(const std::vector<std::string>& paths, Progress progress, Loaded loaded, Finished finished)
+		{
+			if(m_busy.load()){
+				return false;
+			}
+			join();
+
+			m_busy.store(true);
+			m_cancel.store(false);
+			m_worker=std::thread([this, paths, progress, loaded, finished]{
+				for(const std::string& path : paths){
+					if(m_cancel.load()){
+						break;
+					}
+					load(path, progress, loaded);
+				}
+				bool cancelled=m_cancel.load();
+				m_busy.store(false);
+				finished(cancelled);
+			});
+			return true;
+		}
+
+		void cancel()
+		{
+			m_cancel.store(true);
+		}
+
+		bool busy() const
+		{
+			return m_busy.load();
+		}
+
+		bool cancelled() const
+		{
+			return m_cancel.load();
+		}
+
+		/*
+		 * Write the pyramids of large files to their cache, on by
+		 * default. Off for read-only or shared directories; a cache
+		 * already there is still read.
+		 *
+		 * */
+		void cachePyramids(bool cache)
+		{
+			m_cachePyramids.store(cache);
+		}
+
+	private:
+		std::thread m_worker{};
+		std::atomic<bool> m_busy{false};
+		std::atomic<bool> m_cancel{false};
+		std::atomic<bool> m_cachePyramids{true};
+
+		void join()
+		{
+			if(m_worker.joinable()){
+				m_worker.join();
+			}
+		}
+
+		/*
+		 * DataSetBuilder reporting progress and checking for cancellation.
+		 *
+		 * */
+		class Builder : public tprofiler::DataSetBuilder
+		{
+			public:
+				Builder(tprofiler::DataSet& dataSet, std::size_t size, const std::string& file, const Progress& progress, const std::atomic<bool>& cancel)
+				: tprofiler::DataSetBuilder(dataSet)
+				, m_size(size)
+				, m_file(file)
+				, m_progress(progress)
+				, m_cancel(cancel)
+				{
+				}
+
+				bool progress(std::size_t bytes) override
+				{
+					m_progress(m_size>0 ? static_cast<double>(bytes)/m_size : 1, m_file);
+					return !m_cancel.load();
+				}
+
+			private:
+				std::size_t m_size;
+				const std::string& m_file;
+				const Progress& m_progress;
+				const std::atomic<bool>& m_cancel;
+		};
+
+		void load(const std::string& path, const Progress& progress, const Loaded& loaded)
+		{
+			std::string file=path.substr(path.find_last_of('/')+1);
+			try{
+				tprofiler::DataSet dataSet;
+				{
+					tprofiler::MappedFile mapped(path);
+					Builder builder(dataSet, mapped.size(), file, progress, m_cancel);
+					bool complete;
+					if(tprofiler::isBinaryDataSet(mapped.data(), mapped.size())){
+						complete=tprofiler::parseBinaryDataSet(mapped.data(), mapped.size(), builder);
+					}
+					else if(tprofiler::isDataSetStream(mapped.data(), mapped.size())){
+						complete=tprofiler::parseDataSetStream(mapped.data(), mapped.size(), builder);
+					}
+					else{
+						tprofiler::BufferSource source(mapped.data(), mapped.size());
+						tprofiler::DataSetParser<tprofiler::BufferSource> parser(source, builder);
+						complete=parser.parse();
+					}
+					if(!complete){
+						return;
+					}
+				}
+
+				progress(1, file);
+				ChartData::prepare(dataSet);
+				std::string warning;
+				std::vector<tprofiler::LodPyramid> pyramids=loadPyramids(path, dataSet, warning);
+				loaded(std::move(dataSet), std::move(pyramids), warning.empty() ? "" : file+": "+warning);
+			}
+			catch(const std::exception& e){
+				loaded(tprofiler::DataSet{}, {}, file+": "+e.what());
+			}
+		}
+
+		/*
+		 * Read from the cache if it was built from this version of the
+		 * file, built and cached for large files otherwise. The cache is
+		 * only an optimisation: failing to write it is a warning.
+		 *
+		 * */
+		std::vector<tprofiler::LodPyramid> loadPyramids(const std::string& path, const tprofiler::DataSet& dataSet, std::string& warning) const
+		{
+			std::error_code ec;
+			std::uint64_t size=std::filesystem::file_size(path, ec);
+			std::uint64_t modified=static_cast<std::uint64_t>(std::filesystem::last_write_time(path, ec).time_since_epoch().count());
+			std::uint64_t stamp=size*0x9E3779B97F4A7C15ull^modified;
+
+			std::vector<tprofiler::LodPyramid> pyramids;
+			std::string cachePath=path+".lod";
+			std::ifstream cache(cachePath, std::ios::binary);
+			if(cache && tprofiler::readPyramids(cache, dataSet.series, stamp, pyramids)){
+				return pyramids;
+			}
+
+			pyramids=tprofiler::buildPyramids(dataSet.series);
+			std::size_t samples=0;
+			for(const tprofiler::Series& series : dataSet.series){
+				samples+=series.data.size();
+			}
+			if(samples>=CACHE_SAMPLES && m_cachePyramids.load()){
+				std::ofstream out(cachePath, std::ios::binary|std::ios::trunc);
+				if(out){
+					tprofiler::writePyramids(out, pyramids, stamp);
+					out.close();
+					if(!out){
+						std::filesystem::remove(cachePath, ec);
+					}
+				}
+				if(!out){
+					warning="cannot write the cache "+cachePath+", the pyramids will be built again on the next load";
+				}
+			}
+			return pyramids;
+		}
+};
+
+//====================================================================
+
+#endif
@@ -8,11 +8,46 @@
 * Date:    23-10-2025                                                *
 * Author:  Dan Machado                                               *
 **********************************************************************/
+#include <cstdio>
+#include <cstdlib>
 #include <filesystem>
 #include <fstream>
+#include <functional>
+#include <memory>
+#include <sstream>
 #include <wx/wx.h>
 #include <wx/webview.h>
 #include <wx/icon.h>
+#include <wx/filedlg.h>
+#include <wx/dirdlg.h>
+#include <wx/dnd.h>
+
+#include <time_profiler/comparison.h>
+#include <time_profiler/dataset_file.h>
+
+#include "chart_data.h"
+#include "dataset_loader.h"
+#include "live_tail.h"
+
+//====================================================================
+
+class DataSetDropTarget : public wxFileDropTarget
+{
+	public:
+		explicit DataSetDropTarget(std::function<void(const wxArrayString&)> onDrop)
+		: m_onDrop(onDrop)
+		{
+		}
+
+		bool OnDropFiles(wxCoord, wxCoord, const wxArrayString& files) override
+		{
+			m_onDrop(files);
+			return true;
+		}
+
+	private:
+		std::function<void(const wxArrayString&)> m_onDrop;
+};
 
 //====================================================================
 
@@ -52,7 +87,14 @@ public:
 		
 		m_webViewPtr = wxWebView::New(this, wxID_ANY, htmlPath);
 
+		// TPROFILER_LOD_CACHE=0 for datasets in read-only or shared directories
+		const char* lodCache=getenv("TPROFILER_LOD_CACHE");
+		m_loader.cachePyramids(lodCache==nullptr || std::string(lodCache)!="0");
+
 		m_webViewPtr->AddScriptMessageHandler("wx_msg");
+		m_webViewPtr->SetDropTarget(new DataSetDropTarget([this](const wxArrayString& files){
+			loadFiles(files);
+		}));
 
 		std::string cmdStr("xdg-open ");
 		cmdStr.append(htmlPath);
@@ -61,6 +103,28 @@ public:
 			if(evt.GetString()=="install"){
 				autoInstall();
 			}
+			else if(evt.GetString()=="compare"){
+				compareFiles();
+			}
+			else if(evt.GetString()=="load"){
+				openFiles();
+			}
+			else if(evt.GetString()=="cancel"){
+				cancelLoad();
+			}
+			else if(evt.GetString().StartsWith("view:")){
+				viewRequested(std::string(evt.GetString().ToUTF8()));
+			}
+			else if(evt.GetString()=="clear"){
+				m_chart.clear();
+				stopLive();
+			}
+			else if(evt.GetString()=="live"){
+				toggleLive();
+			}
+			else if(evt.GetString().StartsWith("colour:")){
+				colourChanged(std::string(evt.GetString().ToUTF8()));
+			}
 			else{
 				system(cmdStr.c_str());
 			}
@@ -73,12 +137,278 @@ public:
 
 	private:
 		wxWebView* m_webViewPtr;
+		DataSetLoader m_loader;
+		ChartData m_chart;
+		std::size_t m_pixels{1000};
+		LiveTail m_tail;
+		unsigned m_liveSession{0};
 
 		void autoInstall();
+		void compareFiles();
+		bool selectFile(const wxString& title, wxString& path);
+		void openFiles();
+		void loadFiles(const wxArrayString& paths);
+		void cancelLoad();
+		void showProgress(double fraction, const std::string& text);
+		void showView(std::size_t first, std::size_t last);
+		void viewRequested(const std::string& message);
+		void colourChanged(const std::string& message);
+		void toggleLive();
+		void stopLive();
+		void showLive(const LiveTail::Batch& batch);
 };
 
 //--------------------------------------------------------------------
 
+bool TimeProfilerVisualizerApp::selectFile(const wxString& title, wxString& path)
+{
+	wxFileDialog dialog(this, title, wxPathOnly(path), "", "Dataset files (*.js;*.json;*.tpd;*.tps)|*.js;*.json;*.tpd;*.tps|All files|*", wxFD_OPEN|wxFD_FILE_MUST_EXIST);
+	if(dialog.ShowModal()==wxID_CANCEL){
+		return false;
+	}
+	path=dialog.GetPath();
+	return true;
+}
+
+//--------------------------------------------------------------------
+
+/*
+ * Compare a baseline and a candidate file and show the verdicts with
+ * the change of each percentile.
+ *
+ * */
+void TimeProfilerVisualizerApp::compareFiles()
+{
+	wxString baselinePath, candidatePath;
+	if(!selectFile("Baseline dataset", baselinePath)){
+		return;
+	}
+	candidatePath=baselinePath;
+	if(!selectFile("Candidate dataset", candidatePath)){
+		return;
+	}
+
+	try{
+		tprofiler::DataSet baseline=tprofiler::readDataSetFile(std::string(baselinePath.ToUTF8()));
+		tprofiler::DataSet candidate=tprofiler::readDataSetFile(std::string(candidatePath.ToUTF8()));
+		std::vector<tprofiler::Comparison> comparisons=tprofiler::compareDataSets(baseline, candidate);
+
+		std::ostringstream script;
+		script<<"showComparison(";
+		tprofiler::writeComparisonDataSet(script, comparisons, baseline.timeUnits);
+		script<<");";
+		m_webViewPtr->RunScript(wxString::FromUTF8(script.str()));
+	}
+	catch(const std::exception& e){
+		wxMessageBox(e.what(), "Compare", wxOK|wxICON_ERROR, this);
+	}
+}
+
+//--------------------------------------------------------------------
+
+void TimeProfilerVisualizerApp::openFiles()
+{
+	wxFileDialog dialog(this, "Load datasets", "", "", "Dataset files (*.js;*.json;*.tpd;*.tps)|*.js;*.json;*.tpd;*.tps|All files|*", wxFD_OPEN|wxFD_FILE_MUST_EXIST|wxFD_MULTIPLE);
+	if(dialog.ShowModal()==wxID_CANCEL){
+		return;
+	}
+
+	wxArrayString paths;
+	dialog.GetPaths(paths);
+	loadFiles(paths);
+}
+
+//--------------------------------------------------------------------
+
+/*
+ * Files are parsed on the loader thread and kept by m_chart, the page
+ * is only sent the view being shown.
+ *
+ * */
+void TimeProfilerVisualizerApp::loadFiles(const wxArrayString& paths)
+{
+	stopLive();
+	std::vector<std::string> files;
+	for(const wxString& path : paths){
+		files.emplace_back(path.ToUTF8());
+	}
+
+	bool started=m_loader.start(files,
+		[this](double fraction, const std::string& file){
+			CallAfter([this, fraction, file]{
+				showProgress(fraction, "Loading "+file);
+			});
+		},
+		[this](tprofiler::DataSet&& dataSet, std::vector<tprofiler::LodPyramid>&& pyramids, const std::string& error){
+			auto loaded=std::make_shared<tprofiler::DataSet>(std::move(dataSet));
+			auto index=std::make_shared<std::vector<tprofiler::LodPyramid>>(std::move(pyramids));
+			CallAfter([this, loaded, index, error]{
+				if(!error.empty()){
+					wxMessageBox(wxString::FromUTF8(error), "Load data", wxOK|(loaded->series.empty() ? wxICON_ERROR : wxICON_WARNING), this);
+				}
+				if(m_loader.cancelled() || loaded->series.empty()){
+					return;
+				}
+				m_chart.add(std::move(*loaded), std::move(*index));
+				showView(0, m_chart.samples());
+			});
+		},
+		[this](bool){
+			CallAfter([this]{
+				showProgress(-1, "");
+			});
+		});
+
+	if(!started){
+		wxMessageBox("Wait until the files being loaded are plotted or cancel the load.", "Load data", wxOK|wxICON_INFORMATION, this);
+	}
+}
+
+//--------------------------------------------------------------------
+
+void TimeProfilerVisualizerApp::cancelLoad()
+{
+	m_loader.cancel();
+	showProgress(-1, "");
+}
+
+//--------------------------------------------------------------------
+
+/*
+ * @param fraction negative to hide the progress bar
+ * */
+void TimeProfilerVisualizerApp::showProgress(double fraction, const std::string& text)
+{
+	std::ostringstream script;
+	script<<"nativeLoader.progress("<<fraction<<", ";
+	tprofiler::writeJsonString(script, text);
+	script<<");";
+	m_webViewPtr->RunScript(wxString::FromUTF8(script.str()));
+}
+
+//--------------------------------------------------------------------
+
+void TimeProfilerVisualizerApp::showView(std::size_t first, std::size_t last)
+{
+	if(!m_chart.empty()){
+		m_webViewPtr->RunScript(wxString::FromUTF8(m_chart.viewScript(first, last, m_pixels)));
+	}
+}
+
+//--------------------------------------------------------------------
+
+/*
+ * "view:first:last:pixels" posted by the page when zooming in or
+ * resetting the zoom.
+ *
+ * */
+void TimeProfilerVisualizerApp::viewRequested(const std::string& message)
+{
+	unsigned long long first=0, last=0, pixels=0;
+	if(std::sscanf(message.c_str(), "view:%llu:%llu:%llu", &first, &last, &pixels)!=3){
+		return;
+	}
+	if(pixels>0){
+		m_pixels=pixels;
+	}
+	showView(first, last);
+}
+
+//--------------------------------------------------------------------
+
+/*
+ * "colour:series:#rrggbb" posted by the colour picker of the keys.
+ *
+ * */
+void TimeProfilerVisualizerApp::colourChanged(const std::string& message)
+{
+	std::size_t colon=message.find(':', 7);
+	if(colon!=std::string::npos){
+		m_chart.setColour(std::strtoul(message.c_str()+7, nullptr, 10), message.substr(colon+1));
+	}
+}
+
+//--------------------------------------------------------------------
+
+/*
+ * Listen for the streams sent by profilers and follow those of a
+ * directory, or stop. Without a directory only the socket is listened
+ * on. The page keeps a bounded history and scrolls as samples arrive.
+ *
+ * */
+void TimeProfilerVisualizerApp::toggleLive()
+{
+	if(m_tail.running()){
+		stopLive();
+		return;
+	}
+
+	std::string directory;
+	wxDirDialog dialog(this, "Directory of the live datasets (Cancel: socket only)", "", wxDD_DEFAULT_STYLE|wxDD_DIR_MUST_EXIST);
+	if(dialog.ShowModal()==wxID_OK){
+		directory=dialog.GetPath().ToUTF8();
+	}
+
+	try{
+		// batches of a previous session still queued are dropped
+		unsigned session=++m_liveSession;
+		m_tail.start(directory, tprofiler::defaultStreamSocketPath(), [this, session](LiveTail::Batch&& batch){
+			auto shared=std::make_shared<LiveTail::Batch>(std::move(batch));
+			CallAfter([this, session, shared]{
+				if(session==m_liveSession){
+					showLive(*shared);
+				}
+			});
+		});
+		m_chart.clear();
+		m_webViewPtr->RunScript("nativeLoader.live(true);");
+	}
+	catch(const std::exception& e){
+		wxMessageBox(e.what(), "Live", wxOK|wxICON_ERROR, this);
+	}
+}
+
+//--------------------------------------------------------------------
+
+void TimeProfilerVisualizerApp::stopLive()
+{
+	if(m_tail.running()){
+		m_tail.stop();
+		m_liveSession++;
+		m_webViewPtr->RunScript("nativeLoader.live(false);");
+	}
+}
+
+//--------------------------------------------------------------------
+
+void TimeProfilerVisualizerApp::showLive(const LiveTail::Batch& batch)
+{
+	for(const std::string& error : batch.errors){
+		wxMessageBox(wxString::FromUTF8(error), "Live", wxOK|wxICON_ERROR, this);
+	}
+
+	std::ostringstream script;
+	script<<"nativeLoader.tail({\"series\": [";
+	for(std::size_t i=0; i<batch.added.size(); i++){
+		script<<(i>0 ? ", " : "")<<"{\"name\": ";
+		tprofiler::writeJsonString(script, batch.added[i].name);
+		script<<", \"color\": ";
+		tprofiler::writeJsonString(script, batch.added[i].colour);
+		script<<"}";
+	}
+	script<<"], \"yTitle\": ";
+	tprofiler::writeJsonString(script, batch.yTitle);
+	script<<", \"data\": [";
+	for(std::size_t i=0; i<batch.samples.size(); i++){
+		const std::vector<double>& samples=batch.samples[i];
+		script<<(i>0 ? ", " : "")<<'"'<<encodeBase64(samples.data(), samples.size()*sizeof(double))<<'"';
+	}
+	script<<"]});";
+	m_webViewPtr->RunScript(wxString::FromUTF8(script.str()));
+}
+
+//--------------------------------------------------------------------
+
 void TimeProfilerVisualizerApp::autoInstall()
 {
 #ifndef DEBUG
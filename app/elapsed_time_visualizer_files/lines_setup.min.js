@@ -2,10 +2,10 @@
  /*********************************************************************
  * lines_setup.js                                                     *
  *                                                                    *
- * Version: 1.2                                                       *
- * Date:    30-10-2025                              *
+ * Version: 1.3                                                       *
+ * Date:    30-10-2025 (review 16-10-2026)          *
  * Author:  Dan Machado                                               *
  * Require  raphaeljs v2.2.1                                          *
  **********************************************************************/
 
-const pickerSettings={headless:!0,enableAlpha:!1,enableEyedropper:!1,formats:null,defaultFormat:"hex",submitMode:"confirm",showClearButton:!1,dismissOnOutsideClick:!0,staticPlacement:"center center",staticOffset:10};var popUpAPI,objData={canvasID:"canvas",chartType:"lines",title:{text:"Elapsed Time",align:"left"},subTitle:{text:"By samples",align:"left"},gridSettings:{"line-width":1,minDataInterval:30},axisTitles:{xTitle:"Samples",yTitle:"Elapsed time (μs)"},lines:[],keys:{position:"right",align:"top",onClick:function(a,n){const t=new ColorPicker(null,pickerSettings);t.on("pick",function(t){a.attr({fill:t.string("hex")});for(var e=0;e<objData.lines[n].length;e++)objData.lines[n][e].attr({stroke:t.string("hex")}),objData.colours[n]=t.string("hex")}),t.setColor(objData.colours[n]),t.prompt()}.bind(this)},serie:[],dataSet:[],colours:[],offset:0,samples:-1};function ReadCookie(){cookies={};for(var t=document.cookie.split(";"),e=0;e<t.length;e++)name=t[e].split("=")[0],cookies[name.trim()]=t[e].split("=")[1];cookies.hasOwnProperty("appInstalled")&&(document.getElementById("installBtn").disabled=!0)}chartLoader("Lines",objData),document.getElementById("loadBtn").addEventListener("change",function(t){var e=t.target.files[0];e&&((t=new FileReader).readAsText(e,"UTF-8"),t.onload=function(t){var e;try{if((e=JSON.parse(t.target.result.toString())).hasOwnProperty("dataSet")){for(var a=0;a<e.dataSet.length;a++){if(0<e.dataSet[a].data.length-objData.serie.length)for(var n=objData.serie.length;n<e.dataSet[a].data.length;n++)objData.serie.push("s"+(n+1));for(var o=0;o<objData.colours.length;o++)objData.colours[o]==e.dataSet[a].color&&(e.dataSet[a].color="#"+Math.floor(16777215*Math.random()).toString(16));objData.axisTitles.yTitle="Elapsed time ("+e.timeUnits+")",objData.colours.push(e.dataSet[a].color),objData.dataSet.push(e.dataSet[a]),0==e.dataSet[a].data.length&&alert("Data set for "+e.dataSet[a].name+" does not have any records")}reloadChar()}}catch(t){return void alert("File could not be loaded because it has bad syntax or it's corrupted.")}})}),document.getElementById("resetBtn").addEventListener("click",function(){objData.offset=0,objData.samples=-1,reloadChar()}),document.getElementById("clearBtn").addEventListener("click",function(){objData.lines=[],objData.dataSet=[],objData.serie=[],objData.colours=[],objData.offset=0,objData.samples=-1,reloadChar()}),function(){var o=0,i=0;document.getElementById("canvas").addEventListener("mousedown",function(t){o=t.offsetX}),document.getElementById("canvas").addEventListener("mouseup",function(t){if(i=t.offsetX,0<objData.serie.length&&i!=o){var e=0,a=objData.firstPoint;for(i<o&&(t=o,o=i,i=t);a<o;)a+=objData.intervalLength,e++;for(var n=e;a<i;)a+=objData.intervalLength,n++;1<n-e&&(objData.offset=objData.offset+e,objData.samples=n-e,reloadChar())}}),document.getElementById("openBtn").addEventListener("click",function(){window.wx_msg.postMessage("open")}),document.getElementById("installBtn").addEventListener("click",function(){window.wx_msg.postMessage("install")})}(),window.addEventListener("DOMContentLoaded",function(){var e,a,t,n;window.scrollTo(0,0),e=document.getElementById("dim"),a=document.getElementById("pop_wrapper"),t=document.getElementById("pop_up"),n=document.getElementById("popup_content"),a.style.top=.1*window.innerHeight+"px",t.style.maxHeight=.8*window.innerHeight+"px",popUpAPI={display:function(){e.style.display="block",a.style.visibility="visible"},closing:function(t){void 0===t?(a.style.visibility="hidden",e.style.display="none",document.getElementById("description").style.display="none"):t.stopPropagation()},whatisit:function(){document.getElementById("popup_title").innerHTML="Description",document.getElementById("description").style.display="block",this.display()}},document.getElementById("closePopUp").addEventListener("click",function(){popUpAPI.closing()}),e.addEventListener("click",function(){popUpAPI.closing()}),a.addEventListener("click",function(){popUpAPI.closing()}),n.addEventListener("click",function(t){popUpAPI.closing(t)}),document.getElementById("whatisit").addEventListener("click",function(){popUpAPI.whatisit()}),ReadCookie(),""==document.cookie&&(document.cookie="whatisit=yes")});
\ No newline at end of file
+const pickerSettings={headless:!0,enableAlpha:!1,enableEyedropper:!1,formats:null,defaultFormat:"hex",submitMode:"confirm",showClearButton:!1,dismissOnOutsideClick:!0,staticPlacement:"center center",staticOffset:10};var popUpAPI,objData={canvasID:"canvas",chartType:"lines",title:{text:"Elapsed Time",align:"left"},subTitle:{text:"By samples",align:"left"},gridSettings:{"line-width":1,minDataInterval:30},axisTitles:{xTitle:"Samples",yTitle:"Elapsed time (μs)"},onSelect:function(o,i){var t;if(0<objData.serie.length&&i!=o){var e=0,a=objData.firstPoint;for(i<o&&(t=o,o=i,i=t);a<o;)a+=objData.intervalLength,e++;for(var n=e;a<i;)a+=objData.intervalLength,n++;1<n-e&&(objData.view?requestView(objData.offset+e,objData.offset+n):(objData.live&&(objData.live.follow=!1),objData.offset=objData.offset+e,objData.samples=n-e,updateChar()))}},keys:{position:"right",align:"top",onClick:function(a,n){const t=new ColorPicker(null,pickerSettings);t.on("pick",function(t){a.attr({fill:t.string("hex")});objData.colours[n]=t.string("hex"),redrawChar(n),objData.view&&window.wx_msg.postMessage("colour:"+n+":"+t.string("hex"))}),t.setColor(objData.colours[n]),t.prompt()}.bind(this)},serie:[],dataSet:[],colours:[],offset:0,samples:-1,capacity:0};function splitLabels(t){for(var e=[],a=0;a<t.length;a++)if(t[a].hasOwnProperty("labels")&&t[a].hasOwnProperty("labelNames"))for(var n=0;n<t[a].labelNames.length;n++){for(var o=[],r=[],i=0;i<t[a].labels.length;i++)t[a].labels[i]==n&&(o.push(t[a].data[i]),t[a].hasOwnProperty("work")&&r.push(t[a].work[i]));0<o.length&&(o={name:t[a].name+(""==t[a].labelNames[n]?"":" ["+t[a].labelNames[n]+"]"),color:0==n?t[a].color:changeColor(t[a].color,Math.min(.85,.15*n)),data:o},t[a].hasOwnProperty("work")&&(o.work=r),e.push(o))}else e.push(t[a]);return e}function toRates(t){if(t.hasOwnProperty("workUnits"))for(var e=0;e<t.dataSet.length;e++)if(t.dataSet[e].hasOwnProperty("work")){t.dataSet[e].elapsed=t.dataSet[e].data,t.dataSet[e].data=[];for(var a=0;a<t.dataSet[e].elapsed.length;a++)t.dataSet[e].data.push(0<t.dataSet[e].elapsed[a]?t.dataSet[e].work[a]/t.dataSet[e].elapsed[a]:0)}return t.hasOwnProperty("yTitle")?t.yTitle:t.hasOwnProperty("workUnits")?"Throughput ("+t.workUnits+"/"+t.timeUnits+")":"Elapsed time ("+t.timeUnits+")"}function applyXAxis(t){if(t.hasOwnProperty("x")){for(var e=0;e<t.x.length;e++)objData.serie[e]=t.hasOwnProperty("xLabels")?t.xLabels[e]:String(t.x[e]);objData.axisTitles.xTitle=t.hasOwnProperty("xTitle")?t.xTitle:"Samples"}}function clearData(){(objData.view||objData.live)&&window.wx_msg&&window.wx_msg.postMessage("clear"),objData.view=null,objData.live=null,objData.axisTitles.xTitle="Samples",objData.dataSet=[],objData.serie=[],objData.colours=[],objData.offset=0,objData.samples=-1,objData.capacity=0}function addDataSet(e){if(e.hasOwnProperty("dataSet")){objData.view&&clearData();e.dataSet=splitLabels(e.dataSet);var l=toRates(e);for(var a=0;a<e.dataSet.length;a++){if(0<e.dataSet[a].data.length-objData.serie.length)for(var n=objData.serie.length;n<e.dataSet[a].data.length;n++)objData.serie.push("s"+(n+1));for(var o=0;o<objData.colours.length;o++)objData.colours[o]==e.dataSet[a].color&&(e.dataSet[a].color="#"+Math.floor(16777215*Math.random()).toString(16));objData.axisTitles.yTitle=l,objData.colours.push(e.dataSet[a].color),objData.dataSet.push(e.dataSet[a]),0==e.dataSet[a].data.length&&alert("Data set for "+e.dataSet[a].name+" does not have any records")}applyXAxis(e),reloadChar()}}function showComparison(t){clearData(),addDataSet(t);var e=t.header&&t.header.comparison?t.header.comparison:[],a="<table><tr><th>Series</th><th>Verdict</th><th>Median</th><th>Change</th><th>95% CI</th><th>p-value</th></tr>";0==e.length&&(a+='<tr><td colspan="6">No series in common</td></tr>');for(var n=0;n<e.length;n++){var o=e[n],r=o.significant?"slower"==o.verdict?"#e6194b":"#3cb44b":"inherit";a+="<tr><td>"+o.name+'</td><td style="color:'+r+'">'+o.verdict+"</td><td>"+o.baselineMedian.toPrecision(4)+" &rarr; "+o.candidateMedian.toPrecision(4)+" "+t.timeUnits+"</td><td>"+(0<o.change?"+":"")+(100*o.change).toFixed(2)+"%</td><td>["+o.differenceLower.toPrecision(3)+", "+o.differenceUpper.toPrecision(3)+"]</td><td>"+o.pValue.toPrecision(3)+"</td></tr>"}document.getElementById("comparison").innerHTML=a+"</table>",popUpAPI.comparison()}function readFile(t){var e=new FileReader;e.readAsText(t,"UTF-8"),e.onload=function(e){try{addDataSet(JSON.parse(e.target.result.toString()))}catch(e){return void alert(t.name+" could not be loaded because it has bad syntax or it's corrupted.")}}}function decodeBase64(t){for(var e=atob(t),a=new Uint8Array(e.length),n=0;n<e.length;n++)a[n]=e.charCodeAt(n);return a}function appendSamples(t){for(var e=objData.serie.length,a=0;a<t.data.length&&a<objData.dataSet.length;a++)for(var n=0;n<t.data[a].length;n++)objData.dataSet[a].data.push(t.data[a][n]),objData.dataSet[a].data.length>objData.serie.length&&objData.serie.push(t.labels&&t.labels[objData.serie.length-e]||"s"+(objData.serie.length+1));objData.samples<0&&objData.serie.length>objData.capacity&&(objData.capacity=2*objData.serie.length),appendChar(e)}function appendLive(t,e){for(var a=objData.live,n=objData.serie.length,o=!1,i=0;i<t.length&&i<objData.dataSet.length;i++)for(var r=objData.dataSet[i].data,l=0;l<t[i].length;l++)r.push(t[i][l]);for(i=0;i<objData.dataSet.length;i++)for(;objData.serie.length<objData.dataSet[i].data.length;)objData.serie.push("s"+(a.dropped+objData.serie.length+1));var s=objData.serie.length-a.history;if(a.history/4<s){for(i=0;i<objData.dataSet.length;i++)objData.dataSet[i].data.splice(0,s);objData.serie.splice(0,s),a.dropped+=s,n=Math.max(0,n-s),objData.offset=Math.max(0,objData.offset-s),o=!0}a.follow&&objData.serie.length>a.window&&(objData.offset=objData.serie.length-a.window,objData.samples=a.window,o=!0),e?reloadChar():o?updateChar():appendChar(n)}function requestView(t,e){var a=objData.view.start,n=a[t];for(t=e+1;t<a.length&&a[t]==a[e];)t++;e=t<a.length?a[t]:objData.view.last,1<e-n&&window.wx_msg.postMessage("view:"+n+":"+e+":"+document.getElementById("canvas").clientWidth)}var nativeLoader={view:function(t){for(var e=0;e<t.dataSet.length;e++)t.dataSet[e].data=new Float64Array(decodeBase64(t.dataSet[e].data).buffer);objData.dataSet=t.dataSet,objData.colours=t.dataSet.map(function(t){return t.color}),objData.serie=t.labels,objData.axisTitles.xTitle=t.xTitle,objData.axisTitles.yTitle=t.yTitle,objData.offset=0,objData.samples=-1,objData.view={start:t.start,first:t.first,last:t.last,total:t.total},updateChar()},live:function(t){t?(objData.view=null,clearData(),objData.live={window:1e3,history:1e5,follow:!0,dropped:0},objData.capacity=objData.live.window,reloadChar()):objData.live=null,document.getElementById("liveText").textContent=t?"Stop live":"Live"},tail:function(t){if(objData.live){for(var e=objData.serie.length,a=0;a<t.series.length;a++)objData.dataSet.push({name:t.series[a].name,color:t.series[a].color,data:new Array(e).fill(NaN)}),objData.colours.push(t.series[a].color);t.yTitle&&(objData.axisTitles.yTitle=t.yTitle);for(var n=[],a=0;a<t.data.length;a++)n.push(Array.from(new Float64Array(decodeBase64(t.data[a]).buffer)));appendLive(n,0<t.series.length)}},progress:function(t,e){var a=document.getElementById("loading");t<0?a.style.display="none":(a.style.display="block",document.getElementById("loadingText").textContent=e,document.getElementById("loadingBar").value=t)}};function ReadCookie(){cookies={};for(var t=document.cookie.split(";"),e=0;e<t.length;e++)name=t[e].split("=")[0],cookies[name.trim()]=t[e].split("=")[1];cookies.hasOwnProperty("appInstalled")&&(document.getElementById("installBtn").disabled=!0)}chartLoader("Lines",objData),document.getElementById("loadBtn").addEventListener("change",function(t){for(var e=0;e<t.target.files.length;e++)readFile(t.target.files[e]);t.target.value=""}),document.getElementById("loadData").addEventListener("click",function(t){window.wx_msg&&(t.preventDefault(),window.wx_msg.postMessage("load"))}),document.addEventListener("dragover",function(t){t.preventDefault()}),document.addEventListener("drop",function(t){t.preventDefault();for(var e=0;e<t.dataTransfer.files.length;e++)readFile(t.dataTransfer.files[e])}),document.getElementById("cancelLoadBtn").addEventListener("click",function(){window.wx_msg&&window.wx_msg.postMessage("cancel"),nativeLoader.progress(-1,"")}),document.getElementById("resetBtn").addEventListener("click",function(){objData.view?window.wx_msg.postMessage("view:0:"+objData.view.total+":"+document.getElementById("canvas").clientWidth):objData.live?(objData.live.follow=!0,objData.offset=Math.max(0,objData.serie.length-objData.live.window),objData.samples=0<objData.offset?objData.live.window:-1,updateChar()):(objData.offset=0,objData.samples=-1,updateChar())}),document.getElementById("clearBtn").addEventListener("click",function(){clearData(),reloadChar()}),function(){document.getElementById("openBtn").addEventListener("click",function(){window.wx_msg.postMessage("open")}),document.getElementById("installBtn").addEventListener("click",function(){window.wx_msg.postMessage("install")}),document.getElementById("compareBtn").addEventListener("click",function(){window.wx_msg.postMessage("compare")}),document.getElementById("liveBtn").addEventListener("click",function(){window.wx_msg&&window.wx_msg.postMessage("live")})}(),window.addEventListener("DOMContentLoaded",function(){var e,a,t,n;window.scrollTo(0,0),e=document.getElementById("dim"),a=document.getElementById("pop_wrapper"),t=document.getElementById("pop_up"),n=document.getElementById("popup_content"),a.style.top=.1*window.innerHeight+"px",t.style.maxHeight=.8*window.innerHeight+"px",popUpAPI={display:function(){e.style.display="block",a.style.visibility="visible"},closing:function(t){void 0===t?(a.style.visibility="hidden",e.style.display="none",document.getElementById("description").style.display="none",document.getElementById("comparison").style.display="none"):t.stopPropagation()},comparison:function(){document.getElementById("popup_title").innerHTML="Comparison",document.getElementById("comparison").style.display="block",this.display()},whatisit:function(){document.getElementById("popup_title").innerHTML="Description",document.getElementById("description").style.display="block",this.display()}},document.getElementById("closePopUp").addEventListener("click",function(){popUpAPI.closing()}),e.addEventListener("click",function(){popUpAPI.closing()}),a.addEventListener("click",function(){popUpAPI.closing()}),n.addEventListener("click",function(t){popUpAPI.closing(t)}),document.getElementById("whatisit").addEventListener("click",function(){popUpAPI.whatisit()}),ReadCookie(),""==document.cookie&&(document.cookie="whatisit=yes")});
\ No newline at end of file
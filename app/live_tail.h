@@ -0,0 +1,440 @@
+/*********************************************************************
+* LiveTail class                                                     *
+*                                                                    *
+* Watches a directory with inotify and follows the dataset streams   *
+* (*.tps) created or growing in it, reading only the bytes appended  *
+* to them. Also listens on a Unix domain socket for the streams sent *
+* by TimeProfiler::streamToSocket(), from any number of processes.   *
+* New samples are reported in batches, split by label and turned     *
+* into rates sample by sample.                                       *
+*                                                                    *
+* Version: 1.1                                                       *
+* Date:    16-10-2026                                                *
+* Author:  Dan Machado                                               *
+**********************************************************************/
+#ifndef LIVE_TAIL_H
+#define LIVE_TAIL_H
+
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <functional>
+#include <map>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/inotify.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <time_profiler/dataset_stream.h>
+#include <time_profiler/stream_socket.h>
+
+#include "chart_data.h"
+
+//====================================================================
+
+class LiveTail
+{
+	public:
+		struct NewSeries
+		{
+			std::string name;
+			std::string colour;
+		};
+
+		/*
+		 * Series are numbered in the order they appear, from the start
+		 * of the session: one per stream and label.
+		 *
+		 * */
+		struct Batch
+		{
+			std::vector<NewSeries> added{};             // series seen for the first time
+			std::vector<std::vector<double>> samples{}; // new samples of every series
+			std::string yTitle{};                       // set with the first series
+			std::vector<std::string> errors{};
+		};
+
+		// called from the watcher thread
+		using Update=std::function<void(Batch&& batch)>;
+
+		// batches are sent at most this often
+		static constexpr int PERIOD_MS=100;
+
+		// samples of a series kept in a batch, older ones are dropped
+		static constexpr std::size_t HISTORY=100000;
+
+		// producers connected at once
+		static constexpr std::size_t MAX_CONNECTIONS=64;
+
+		LiveTail()=default;
+		LiveTail(const LiveTail&)=delete;
+		LiveTail& operator=(const LiveTail&)=delete;
+
+		~LiveTail()
+		{
+			stop();
+		}
+
+		/*
+		 * Follow the streams of directory, those already there from their
+		 * beginning, and those sent to socketPath. Either can be empty.
+		 *
+		 * @throws std::runtime_error if the directory cannot be watched or
+		 *         the socket cannot be listened on
+		 * */
+		void start(const std::string& directory, const std::string& socketPath, Update update)
+		{
+			stop();
+			int fd=-1;
+			int listener=-1;
+			try{
+				if(!directory.empty()){
+					fd=watchDirectory(directory);
+				}
+				if(!socketPath.empty()){
+					listener=listen(socketPath);
+				}
+			}
+			catch(...){
+				if(fd>=0){
+					::close(fd);
+				}
+				throw;
+			}
+
+			m_streams.clear();
+			m_connected=0;
+			m_seriesCount=0;
+			m_stop.store(false);
+			m_worker=std::thread([this, fd, listener, directory, socketPath, update]{
+				watch(fd, listener, directory, update);
+				if(fd>=0){
+					::close(fd);
+				}
+				if(listener>=0){
+					::close(listener);
+					::unlink(socketPath.c_str());
+				}
+			});
+		}
+
+		void stop()
+		{
+			m_stop.store(true);
+			if(m_worker.joinable()){
+				m_worker.join();
+			}
+		}
+
+		bool running() const
+		{
+			return m_worker.joinable();
+		}
+
+	private:
+		struct Stream
+		{
+			std::size_t offset{0};
+			tprofiler::DataSetStreamReader reader{};
+			std::map<std::uint32_t, std::size_t> series{}; // label to series
+			bool failed{false};
+		};
+
+		std::thread m_worker{};
+		std::atomic<bool> m_stop{false};
+
+		// used by the watcher thread only
+		std::map<std::string, Stream> m_streams{};
+		std::map<int, std::string> m_connections{}; // socket to stream
+		std::size_t m_connected{0};
+		std::size_t m_seriesCount{0};
+		std::vector<char> m_buffer{};
+
+		static bool isStream(const std::string& name)
+		{
+			return name.size()>4 && name.compare(name.size()-4, 4, ".tps")==0;
+		}
+
+		static int watchDirectory(const std::string& directory)
+		{
+			int fd=::inotify_init1(IN_NONBLOCK|IN_CLOEXEC);
+			if(fd<0){
+				throw std::runtime_error(std::string("inotify: ")+std::strerror(errno));
+			}
+			if(::inotify_add_watch(fd, directory.c_str(), IN_CREATE|IN_MODIFY|IN_CLOSE_WRITE|IN_MOVED_TO)<0){
+				int error=errno;
+				::close(fd);
+				throw std::runtime_error("cannot watch "+directory+": "+std::strerror(error));
+			}
+			return fd;
+		}
+
+		/*
+		 * A socket left behind by a visualizer that did not exit cleanly is
+		 * replaced, one still listened on is not.
+		 *
+		 * */
+		static int listen(const std::string& path)
+		{
+			sockaddr_un address;
+			if(!tprofiler::makeSocketAddress(path, address)){
+				throw std::runtime_error("invalid socket path "+path);
+			}
+
+			int fd=::socket(AF_UNIX, SOCK_SEQPACKET|SOCK_NONBLOCK|SOCK_CLOEXEC, 0);
+			if(fd<0){
+				throw std::runtime_error(std::string("socket: ")+std::strerror(errno));
+			}
+			if(::connect(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address))==0){
+				::close(fd);
+				throw std::runtime_error(path+" is already being listened on");
+			}
+			::unlink(path.c_str());
+			if(::bind(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address))<0 || ::listen(fd, 16)<0){
+				int error=errno;
+				::close(fd);
+				throw std::runtime_error("cannot listen on "+path+": "+std::strerror(error));
+			}
+			return fd;
+		}
+
+		/*
+		 * Files are read once per period. Sockets are read as soon as
+		 * there is something to read, so the producers are not slowed
+		 * down, their samples are then sent with those of the files.
+		 *
+		 * */
+		void watch(int fd, int listener, const std::string& directory, const Update& update)
+		{
+			std::set<std::string> changed;
+			std::error_code ec;
+			if(fd>=0){
+				for(const std::filesystem::directory_entry& entry : std::filesystem::directory_iterator(directory, ec)){
+					if(isStream(entry.path().filename().string())){
+						changed.insert(entry.path().filename().string());
+					}
+				}
+			}
+
+			m_buffer.resize(1<<20);
+			alignas(inotify_event) char events[16*1024];
+			std::vector<pollfd> descriptors;
+			Batch batch;
+			auto next=std::chrono::steady_clock::now();
+			while(!m_stop.load()){
+				descriptors.clear();
+				descriptors.push_back(pollfd{fd, POLLIN, 0});
+				descriptors.push_back(pollfd{listener, POLLIN, 0});
+				for(const auto& connection : m_connections){
+					descriptors.push_back(pollfd{connection.first, POLLIN, 0});
+				}
+
+				auto wait=std::chrono::duration_cast<std::chrono::milliseconds>(next-std::chrono::steady_clock::now()).count();
+				if(::poll(descriptors.data(), descriptors.size(), static_cast<int>(std::max<long long>(wait, 0)))>0){
+					if(descriptors[0].revents&POLLIN){
+						ssize_t length;
+						while((length=::read(fd, events, sizeof(events)))>0){
+							for(char* e=events; e<events+length;){
+								const inotify_event* event=reinterpret_cast<const inotify_event*>(e);
+								if(event->len>0 && isStream(event->name)){
+									changed.insert(event->name);
+								}
+								e+=sizeof(inotify_event)+event->len;
+							}
+						}
+					}
+					if(descriptors[1].revents&POLLIN){
+						accept(listener);
+					}
+					for(std::size_t i=2; i<descriptors.size(); i++){
+						if(descriptors[i].revents!=0){
+							receive(descriptors[i].fd, batch);
+						}
+					}
+				}
+
+				// changes are gathered over a period and sent at once
+				if(std::chrono::steady_clock::now()<next){
+					continue;
+				}
+				next=std::chrono::steady_clock::now()+std::chrono::milliseconds(PERIOD_MS);
+
+				batch.samples.resize(m_seriesCount);
+				for(const std::string& name : changed){
+					readAppended(directory+"/"+name, name, batch);
+				}
+				changed.clear();
+
+				bool appended=false;
+				for(const std::vector<double>& samples : batch.samples){
+					appended=appended || !samples.empty();
+				}
+				if(appended || !batch.added.empty() || !batch.errors.empty()){
+					update(std::move(batch));
+					batch=Batch{};
+					batch.samples.resize(m_seriesCount);
+				}
+			}
+
+			for(const auto& connection : m_connections){
+				::close(connection.first);
+			}
+			m_connections.clear();
+		}
+
+		void accept(int listener)
+		{
+			int connection;
+			while((connection=::accept4(listener, nullptr, nullptr, SOCK_NONBLOCK|SOCK_CLOEXEC))>=0){
+				if(m_connections.size()>=MAX_CONNECTIONS){
+					::close(connection);
+					continue;
+				}
+				m_connections.emplace(connection, "connection "+std::to_string(++m_connected));
+			}
+		}
+
+		/*
+		 * Every message is a whole number of lines of the stream of the
+		 * connection. The series of a producer that disconnects are kept.
+		 *
+		 * */
+		void receive(int connection, Batch& batch)
+		{
+			const std::string& name=m_connections[connection];
+			Stream& stream=m_streams[name];
+			ssize_t count;
+			while((count=::recv(connection, m_buffer.data(), m_buffer.size(), MSG_DONTWAIT))>0){
+				if(stream.failed){
+					continue;
+				}
+				tprofiler::Series samples;
+				try{
+					stream.reader.feed(m_buffer.data(), static_cast<std::size_t>(count), samples);
+				}
+				catch(const std::exception& e){
+					stream.failed=true;
+					batch.errors.push_back(name+": "+e.what());
+					continue;
+				}
+				distribute(stream, samples, batch);
+			}
+
+			if(count==0 || (errno!=EAGAIN && errno!=EWOULDBLOCK && errno!=EINTR)){
+				::close(connection);
+				m_connections.erase(connection);
+			}
+		}
+
+		void readAppended(const std::string& path, const std::string& name, Batch& batch)
+		{
+			Stream& stream=m_streams[name];
+			if(stream.failed){
+				return;
+			}
+
+			int fd=::open(path.c_str(), O_RDONLY|O_CLOEXEC);
+			if(fd<0){
+				return;
+			}
+			struct stat status;
+			std::size_t size=::fstat(fd, &status)==0 ? static_cast<std::size_t>(status.st_size) : 0;
+
+			// written again from the start, its series go on
+			if(size<stream.offset){
+				stream.offset=0;
+				stream.reader.reset();
+			}
+
+			while(stream.offset<size){
+				ssize_t count=::pread(fd, m_buffer.data(), std::min(m_buffer.size(), size-stream.offset), static_cast<off_t>(stream.offset));
+				if(count<=0){
+					break;
+				}
+				stream.offset+=static_cast<std::size_t>(count);
+
+				tprofiler::Series samples;
+				try{
+					stream.reader.feed(m_buffer.data(), static_cast<std::size_t>(count), samples);
+				}
+				catch(const std::exception& e){
+					stream.failed=true;
+					batch.errors.push_back(name+": "+e.what());
+					break;
+				}
+				distribute(stream, samples, batch);
+			}
+			::close(fd);
+		}
+
+		/*
+		 * Add the samples of a stream to the samples of their series,
+		 * creating the series of the labels seen for the first time.
+		 *
+		 * */
+		void distribute(Stream& stream, const tprofiler::Series& samples, Batch& batch)
+		{
+			if(samples.data.empty()){
+				return;
+			}
+
+			// sockets are read between periods, after the batch was sent
+			batch.samples.resize(m_seriesCount);
+
+			const tprofiler::DataSet& info=stream.reader.info();
+			const tprofiler::Series& series=info.series[0];
+			if(m_seriesCount==0){
+				batch.yTitle=ChartData::defaultYTitle(info);
+			}
+
+			bool rates=!info.workUnits.empty();
+			std::uint32_t label=0;
+			std::vector<double>* values=nullptr;
+			for(std::size_t i=0; i<samples.data.size(); i++){
+				if(values==nullptr || samples.labels[i]!=label){
+					label=samples.labels[i];
+					auto found=stream.series.find(label);
+					if(found==stream.series.end()){
+						NewSeries added{series.name, series.colour};
+						if(label>0){
+							if(label<series.labelNames.size() && !series.labelNames[label].empty()){
+								added.name+=" ["+series.labelNames[label]+"]";
+							}
+							added.colour=tprofiler::lighterColour(series.colour, std::min(0.85, 0.15*label));
+						}
+						batch.added.push_back(added);
+						found=stream.series.emplace(label, m_seriesCount++).first;
+						batch.samples.resize(m_seriesCount);
+					}
+					values=&batch.samples[found->second];
+				}
+
+				double value=samples.data[i];
+				if(rates){
+					value=value>0 ? samples.work[i]/value : 0;
+				}
+				values->push_back(value);
+			}
+
+			for(std::vector<double>& kept : batch.samples){
+				if(kept.size()>2*HISTORY){
+					kept.erase(kept.begin(), kept.end()-HISTORY);
+				}
+			}
+		}
+};
+
+//====================================================================
+
+#endif
@@ -0,0 +1,72 @@
+/*********************************************************************
+* live_tail_check                                                    *
+*                                                                    *
+* Round trip of TimeProfiler::streamToSocket() to LiveTail: a        *
+* producer sends its samples in several messages, spread over more   *
+* than one period, and every sample must reach the update callback.  *
+*                                                                    *
+* Version: 1.0                                                       *
+* Date:    16-10-2026                                                *
+* Author:  Dan Machado                                               *
+**********************************************************************/
+#define ENABLE_STOPWATCH
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+
+#include <time_profiler/time_profiler.h>
+
+#include "live_tail.h"
+
+//====================================================================
+
+int main()
+{
+	const std::size_t batches=20;
+	const std::size_t batchSize=8;
+	const std::string path="/tmp/live_tail_check-"+std::to_string(::getpid())+".sock";
+
+	std::atomic<std::size_t> received{0};
+	LiveTail tail;
+	try{
+		tail.start("", path, [&received](LiveTail::Batch&& batch){
+			for(const std::vector<double>& samples : batch.samples){
+				received+=samples.size();
+			}
+		});
+	}
+	catch(const std::exception& e){
+		std::cerr<<e.what()<<'\n';
+		return EXIT_FAILURE;
+	}
+
+	{
+		tprofiler::TimeProfiler<std::chrono::microseconds> timeProfiler("check", "#1f77b4");
+		timeProfiler.streamToSocket(path, batchSize);
+		for(std::size_t i=0; i<batches; i++){
+			for(std::size_t j=0; j<batchSize; j++){
+				timeProfiler.start();
+				timeProfiler.takeSample();
+			}
+			// some messages arrive between periods
+			std::this_thread::sleep_for(std::chrono::milliseconds(LiveTail::PERIOD_MS/3));
+		}
+	}
+
+	auto deadline=std::chrono::steady_clock::now()+std::chrono::seconds(5);
+	while(received.load()<batches*batchSize && std::chrono::steady_clock::now()<deadline){
+		std::this_thread::sleep_for(std::chrono::milliseconds(LiveTail::PERIOD_MS));
+	}
+	tail.stop();
+
+	if(received.load()!=batches*batchSize){
+		std::cerr<<"received "<<received.load()<<" samples of "<<batches*batchSize<<'\n';
+		return EXIT_FAILURE;
+	}
+	std::cout<<"received "<<received.load()<<" samples\n";
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,417 @@
+/*********************************************************************
+* time_profiler_dataset                                              *
+*                                                                    *
+* Command line utility to merge, slice, downsample and convert the   *
+* dataset files output by the time profiler library, and to print    *
+* their summary statistics. Files are memory-mapped and read in      *
+* parallel. Also collects the samples profilers write to a shared-   *
+* memory region into one dataset.                                    *
+*                                                                    *
+* Version: 1.1                                                       *
+* Date:    16-10-2026                                                *
+* Author:  Dan Machado                                               *
+**********************************************************************/
+#include <chrono>
+#include <csignal>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <time_profiler/dataset_file.h>
+#include <time_profiler/shared_collector.h>
+#include <time_profiler/statistics.h>
+
+//====================================================================
+
+namespace
+{
+	struct Options
+	{
+		std::string command{};
+		std::vector<std::string> inputs{};
+		std::string output{};
+		std::size_t from{0};
+		std::size_t to{static_cast<std::size_t>(-1)};
+		std::size_t factor{0};
+		std::size_t points{0};
+		std::string method{"mean"};
+		unsigned threads{0};
+		std::string region{"time_profiler"};
+		double seconds{0};
+	};
+
+//--------------------------------------------------------------------
+
+	void usage()
+	{
+		std::cout<<"usage: time_profiler_dataset COMMAND [options] files...\n\n";
+		std::cout<<"commands:\n";
+		std::cout<<"  summary                 print the statistics of every series of every file\n";
+		std::cout<<"  merge                   write the series of all the files to one dataset\n";
+		std::cout<<"  slice                   keep the samples [--from, --to) of every series\n";
+		std::cout<<"  downsample              reduce every series by --factor N or to --points N\n";
+		std::cout<<"  convert                 write the file in the format given by the output name\n";
+		std::cout<<"  collect                 drain the shared-memory region profilers write to with\n";
+		std::cout<<"                          shareTo() until interrupted, no input files\n\n";
+		std::cout<<"The files are merged before slice, downsample and convert are applied.\n\n";
+		std::cout<<"options:\n";
+		std::cout<<"  -o, --output FILE       output file, binary if it ends in .tpd, text otherwise\n";
+		std::cout<<"  --from N                first sample kept by slice (default 0)\n";
+		std::cout<<"  --to N                  sample after the last one kept by slice (default all)\n";
+		std::cout<<"  --factor N              downsample: one point for every N samples\n";
+		std::cout<<"  --points N              downsample: at most N points per series\n";
+		std::cout<<"  --method M              downsample: mean (default), median, min or max\n";
+		std::cout<<"  -j, --threads N         files read in parallel (default one per core)\n";
+		std::cout<<"  --region NAME           collect: region to drain (default time_profiler)\n";
+		std::cout<<"  --seconds N             collect: stop after N seconds\n";
+		std::cout<<"  -h, --help              show this help\n";
+	}
+
+	bool parseOptions(int argc, char** argv, Options& options)
+	{
+		if(argc<2){
+			return false;
+		}
+
+		options.command=argv[1];
+		for(int i=2; i<argc; i++){
+			std::string arg=argv[i];
+			bool hasValue=i+1<argc;
+			if(arg=="-h" || arg=="--help"){
+				return false;
+			}
+			else if((arg=="-o" || arg=="--output") && hasValue){
+				options.output=argv[++i];
+			}
+			else if(arg=="--from" && hasValue){
+				options.from=std::strtoull(argv[++i], nullptr, 10);
+			}
+			else if(arg=="--to" && hasValue){
+				options.to=std::strtoull(argv[++i], nullptr, 10);
+			}
+			else if(arg=="--factor" && hasValue){
+				options.factor=std::strtoull(argv[++i], nullptr, 10);
+			}
+			else if(arg=="--points" && hasValue){
+				options.points=std::strtoull(argv[++i], nullptr, 10);
+			}
+			else if(arg=="--method" && hasValue){
+				options.method=argv[++i];
+			}
+			else if((arg=="-j" || arg=="--threads") && hasValue){
+				options.threads=static_cast<unsigned>(std::strtoul(argv[++i], nullptr, 10));
+			}
+			else if(arg=="--region" && hasValue){
+				options.region=argv[++i];
+			}
+			else if(arg=="--seconds" && hasValue){
+				options.seconds=std::strtod(argv[++i], nullptr);
+			}
+			else if(!arg.empty() && arg[0]=='-'){
+				std::cout<<"Unknown option: "<<arg<<"\n";
+				return false;
+			}
+			else{
+				options.inputs.push_back(arg);
+			}
+		}
+
+		if(options.inputs.empty() && options.command!="collect"){
+			std::cout<<"No input files\n";
+			return false;
+		}
+		if(options.command!="summary" && options.output.empty()){
+			std::cout<<options.command<<" requires --output\n";
+			return false;
+		}
+		if(options.command=="downsample" && options.factor==0 && options.points==0){
+			std::cout<<"downsample requires --factor or --points\n";
+			return false;
+		}
+		if(options.method!="mean" && options.method!="median" && options.method!="min" && options.method!="max"){
+			std::cout<<"Unknown method: "<<options.method<<"\n";
+			return false;
+		}
+		return true;
+	}
+
+//--------------------------------------------------------------------
+
+	std::string fileName(const std::string& path)
+	{
+		std::size_t slash=path.find_last_of('/');
+		return slash==std::string::npos ? path : path.substr(slash+1);
+	}
+
+	/*
+	 * Series of all the datasets in one. The x-axis is kept if it is
+	 * the same in all of them, the headers are kept under "merged".
+	 *
+	 * @throws std::runtime_error if the time units differ
+	 * */
+	tprofiler::DataSet merge(std::vector<tprofiler::DataSet>& dataSets, const std::vector<std::string>& paths)
+	{
+		if(dataSets.size()==1){
+			return std::move(dataSets.front());
+		}
+
+		tprofiler::DataSet merged;
+		const tprofiler::DataSet& first=dataSets.front();
+		merged.timeUnits=first.timeUnits;
+		merged.xTitle=first.xTitle;
+		merged.yTitle=first.yTitle;
+		merged.x=first.x;
+		merged.xLabels=first.xLabels;
+
+		std::ostringstream header;
+		header<<"{\"merged\": [";
+		for(std::size_t i=0; i<dataSets.size(); i++){
+			tprofiler::DataSet& dataSet=dataSets[i];
+			if(dataSet.timeUnits!=merged.timeUnits){
+				throw std::runtime_error(paths[i]+" is in "+dataSet.timeUnits+", not in "+merged.timeUnits);
+			}
+			if(dataSet.x!=merged.x || dataSet.xLabels!=merged.xLabels){
+				merged.x.clear();
+				merged.xLabels.clear();
+				merged.xTitle.clear();
+			}
+			if(merged.workUnits.empty()){
+				merged.workUnits=dataSet.workUnits;
+			}
+
+			header<<(i>0 ? ", " : "")<<"{\"file\": ";
+			tprofiler::writeJsonString(header, fileName(paths[i]));
+			if(!dataSet.header.empty()){
+				header<<", \"header\": "<<dataSet.header;
+			}
+			header<<"}";
+
+			for(tprofiler::Series& series : dataSet.series){
+				merged.series.push_back(std::move(series));
+			}
+		}
+		header<<"]}";
+		merged.header=header.str();
+		return merged;
+	}
+
+	template<typename T>
+	void sliceColumn(std::vector<T>& column, std::size_t from, std::size_t to)
+	{
+		to=std::min(to, column.size());
+		from=std::min(from, to);
+		column=std::vector<T>(column.begin()+from, column.begin()+to);
+	}
+
+	void slice(tprofiler::DataSet& dataSet, std::size_t from, std::size_t to)
+	{
+		std::size_t longest=0;
+		for(tprofiler::Series& series : dataSet.series){
+			longest=std::max(longest, series.data.size());
+			sliceColumn(series.data, from, to);
+			sliceColumn(series.work, from, to);
+			sliceColumn(series.labels, from, to);
+		}
+		if(dataSet.x.size()==longest){
+			sliceColumn(dataSet.x, from, to);
+			if(dataSet.xLabels.size()==longest){
+				sliceColumn(dataSet.xLabels, from, to);
+			}
+		}
+	}
+
+	double reduce(std::vector<double>& block, const std::string& method)
+	{
+		if(method=="min"){
+			return *std::min_element(block.begin(), block.end());
+		}
+		if(method=="max"){
+			return *std::max_element(block.begin(), block.end());
+		}
+		if(method=="median"){
+			return tprofiler::stats::median(block);
+		}
+		return tprofiler::stats::mean(block);
+	}
+
+	/*
+	 * Replace every block of factor samples of the same label by one
+	 * point, placed where the block starts: the elapsed times are
+	 * reduced with method and the work is added up.
+	 *
+	 * */
+	void downsample(tprofiler::DataSet& dataSet, const Options& options)
+	{
+		std::size_t longest=0;
+		for(tprofiler::Series& series : dataSet.series){
+			longest=std::max(longest, series.data.size());
+		}
+
+		std::size_t factor=options.factor;
+		if(factor==0){
+			factor=std::max<std::size_t>(1, (longest+options.points-1)/options.points);
+		}
+		if(factor<=1){
+			return;
+		}
+
+		std::vector<double> block;
+		for(tprofiler::Series& series : dataSet.series){
+			std::map<std::uint32_t, std::vector<std::size_t>> byLabel;
+			for(std::size_t i=0; i<series.data.size(); i++){
+				byLabel[i<series.labels.size() ? series.labels[i] : 0].push_back(i);
+			}
+
+			// first sample of every block, with its label
+			std::vector<std::pair<std::size_t, std::uint32_t>> starts;
+			for(const auto& samples : byLabel){
+				for(std::size_t i=0; i<samples.second.size(); i+=factor){
+					starts.emplace_back(i, samples.first);
+				}
+			}
+			std::sort(starts.begin(), starts.end(), [&byLabel](const auto& a, const auto& b){
+				return byLabel[a.second][a.first]<byLabel[b.second][b.first];
+			});
+
+			std::vector<double> data, work;
+			std::vector<std::uint32_t> labels;
+			for(const auto& start : starts){
+				const std::vector<std::size_t>& indices=byLabel[start.second];
+				std::size_t end=std::min(start.first+factor, indices.size());
+				block.clear();
+				double sum=0;
+				for(std::size_t j=start.first; j<end; j++){
+					block.push_back(series.data[indices[j]]);
+					sum+=indices[j]<series.work.size() ? series.work[indices[j]] : 0;
+				}
+				data.push_back(reduce(block, options.method));
+				if(!series.work.empty()){
+					work.push_back(sum);
+				}
+				if(!series.labels.empty()){
+					labels.push_back(start.second);
+				}
+			}
+			series.data=std::move(data);
+			series.work=std::move(work);
+			series.labels=std::move(labels);
+		}
+
+		// x coordinates are not sample numbers, they cannot be merged
+		dataSet.x.clear();
+		dataSet.xLabels.clear();
+		dataSet.xTitle.clear();
+	}
+
+//--------------------------------------------------------------------
+
+	volatile std::sig_atomic_t interrupted=0;
+
+	/*
+	 * Drain the region every 10 ms until interrupted, or for the time
+	 * given, then once more.
+	 *
+	 * */
+	tprofiler::DataSet collect(const Options& options)
+	{
+		tprofiler::SharedCollector collector(options.region);
+		std::signal(SIGINT, [](int){ interrupted=1; });
+		std::signal(SIGTERM, [](int){ interrupted=1; });
+
+		tprofiler::DataSet dataSet;
+		std::size_t samples=0;
+		auto end=std::chrono::steady_clock::now()+std::chrono::duration<double>(options.seconds);
+		std::cout<<"Collecting from "<<options.region<<(options.seconds>0 ? "" : ", Ctrl+C to stop")<<"\n";
+		while(!interrupted && (options.seconds<=0 || std::chrono::steady_clock::now()<end)){
+			samples+=collector.drain(dataSet);
+			std::this_thread::sleep_for(std::chrono::milliseconds(10));
+		}
+		samples+=collector.drain(dataSet);
+
+		std::cout<<samples<<" samples in "<<dataSet.series.size()<<" series, "<<collector.dropped()<<" dropped\n";
+		std::ostringstream header;
+		header<<"{\"collected\": {\"region\": ";
+		tprofiler::writeJsonString(header, options.region);
+		header<<", \"dropped\": "<<collector.dropped()<<"}}";
+		dataSet.header=header.str();
+		return dataSet;
+	}
+
+//--------------------------------------------------------------------
+
+	void printSummary(const std::string& path, const tprofiler::DataSet& dataSet)
+	{
+		std::cout<<fileName(path)<<" ("<<(dataSet.timeUnits.empty() ? "?" : dataSet.timeUnits)<<")\n";
+		for(const tprofiler::Series& series : dataSet.series){
+			std::vector<double> sorted=series.data;
+			std::sort(sorted.begin(), sorted.end());
+			std::cout<<"  "<<std::left<<std::setw(26)<<series.name<<std::right<<std::setw(10)<<sorted.size();
+			if(!sorted.empty()){
+				std::cout<<std::setprecision(5);
+				std::cout<<std::setw(12)<<sorted.front();
+				std::cout<<std::setw(12)<<tprofiler::stats::sortedQuantile(sorted, 0.5);
+				std::cout<<std::setw(12)<<tprofiler::stats::mean(sorted);
+				std::cout<<std::setw(12)<<tprofiler::stats::sortedQuantile(sorted, 0.9);
+				std::cout<<std::setw(12)<<tprofiler::stats::sortedQuantile(sorted, 0.99);
+				std::cout<<std::setw(12)<<sorted.back();
+				std::cout<<std::setw(12)<<tprofiler::stats::standardDeviation(sorted);
+			}
+			std::cout<<"\n";
+		}
+	}
+}
+
+//====================================================================
+
+int main(int argc, char** argv)
+{
+	Options options;
+	if(!parseOptions(argc, argv, options)){
+		usage();
+		return 2;
+	}
+
+	const std::string& command=options.command;
+	if(command!="summary" && command!="merge" && command!="slice" && command!="downsample" && command!="convert" && command!="collect"){
+		std::cout<<"Unknown command: "<<command<<"\n";
+		usage();
+		return 2;
+	}
+
+	try{
+		if(command=="collect"){
+			tprofiler::writeDataSetFile(options.output, collect(options));
+			return 0;
+		}
+
+		std::vector<tprofiler::DataSet> dataSets=tprofiler::readDataSetFiles(options.inputs, options.threads);
+
+		if(command=="summary"){
+			std::cout<<"  "<<std::left<<std::setw(26)<<"series"<<std::right<<std::setw(10)<<"samples";
+			std::cout<<std::setw(12)<<"min"<<std::setw(12)<<"median"<<std::setw(12)<<"mean";
+			std::cout<<std::setw(12)<<"p90"<<std::setw(12)<<"p99"<<std::setw(12)<<"max"<<std::setw(12)<<"stddev"<<"\n";
+			for(std::size_t i=0; i<dataSets.size(); i++){
+				printSummary(options.inputs[i], dataSets[i]);
+			}
+			return 0;
+		}
+
+		tprofiler::DataSet dataSet=merge(dataSets, options.inputs);
+		if(command=="slice"){
+			slice(dataSet, options.from, options.to);
+		}
+		else if(command=="downsample"){
+			downsample(dataSet, options);
+		}
+		tprofiler::writeDataSetFile(options.output, dataSet);
+	}
+	catch(const std::exception& e){
+		std::cout<<"Error: "<<e.what()<<"\n";
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,346 @@
+/*********************************************************************
+* time_profiler_gate                                                 *
+*                                                                    *
+* Command line regression gate for continuous integration: compares  *
+* dataset files output by the time profiler library with a baseline  *
+* file and exits with a non-zero status if a series got slower than  *
+* the configured thresholds.                                         *
+*                                                                    *
+* Version: 1.0                                                       *
+* Date:    16-10-2026                                                *
+* Author:  Dan Machado                                               *
+**********************************************************************/
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <time_profiler/dataset_reader.h>
+#include <time_profiler/histogram.h>
+
+//====================================================================
+
+namespace
+{
+	const int EXIT_PASS=0;
+	const int EXIT_REGRESSION=1;
+	const int EXIT_ERROR=2;
+
+	struct Metric
+	{
+		std::string name{};
+		double quantile{0.5}; // negative for the mean
+		double threshold{5};  // percent
+	};
+
+	struct Options
+	{
+		std::vector<Metric> metrics{};
+		std::vector<std::string> series{};
+		std::string baseline{};
+		std::vector<std::string> candidates{};
+		std::uint64_t minSamples{1};
+		bool allowMissing{false};
+	};
+
+//--------------------------------------------------------------------
+
+	struct FileInfo
+	{
+		std::string path{};
+		std::string timeUnits{};
+		std::string workUnits{};     // throughput dataset if not empty
+		std::string labelledSeries{}; // first series with labels
+	};
+
+	/*
+	 * Samples of every series, files streamed through a LogHistogram per
+	 * series, series with the same name in several files are merged.
+	 * Labelled series are only detected: their data comes before their
+	 * labels and cannot be split without keeping it.
+	 *
+	 * */
+	class SeriesSummaries : public tprofiler::DataSetHandler
+	{
+		public:
+			// call before parsing every file
+			void beginFile(const std::string& path)
+			{
+				m_files.push_back(FileInfo{path});
+			}
+
+			void beginSeries() override
+			{
+				m_current.reset();
+				m_currentName.clear();
+			}
+
+			void endSeries() override
+			{
+				auto it=m_summaries.find(m_currentName);
+				if(it==m_summaries.end()){
+					m_names.push_back(m_currentName);
+					m_summaries.emplace(m_currentName, m_current);
+				}
+				else{
+					it->second.merge(m_current);
+				}
+			}
+
+			void seriesString(const std::string& key, const std::string& value) override
+			{
+				if(key=="name"){
+					m_currentName=value;
+				}
+			}
+
+			void seriesValues(const std::string& key, const double* values, std::size_t count) override
+			{
+				if(key=="data"){
+					for(std::size_t i=0; i<count; i++){
+						m_current.add(values[i]);
+					}
+				}
+				else if(key=="labels" && !m_files.empty() && m_files.back().labelledSeries.empty()){
+					for(std::size_t i=0; i<count; i++){
+						if(values[i]!=0){
+							m_files.back().labelledSeries=m_currentName;
+							break;
+						}
+					}
+				}
+			}
+
+			void field(const std::string& key, const std::string& value) override
+			{
+				if(m_files.empty()){
+					return;
+				}
+				if(key=="timeUnits"){
+					m_files.back().timeUnits=value;
+				}
+				else if(key=="workUnits"){
+					m_files.back().workUnits=value;
+				}
+			}
+
+			const std::vector<std::string>& names() const
+			{
+				return m_names;
+			}
+
+			const tprofiler::LogHistogram* find(const std::string& name) const
+			{
+				auto it=m_summaries.find(name);
+				return it!=m_summaries.end() ? &it->second : nullptr;
+			}
+
+			const std::vector<FileInfo>& files() const
+			{
+				return m_files;
+			}
+
+		private:
+			std::map<std::string, tprofiler::LogHistogram> m_summaries{};
+			std::vector<std::string> m_names{};  // in file order
+			tprofiler::LogHistogram m_current{1024}; // 0.05% relative error
+			std::string m_currentName{};
+			std::vector<FileInfo> m_files{};
+	};
+
+//--------------------------------------------------------------------
+
+	void usage()
+	{
+		std::cout<<"usage: time_profiler_gate [options] baseline candidate [candidate...]\n\n";
+		std::cout<<"Fail (exit status 1) if a series of the candidate files is slower than in the baseline file.\n\n";
+		std::cout<<"options:\n";
+		std::cout<<"  -m, --metric METRIC:PERCENT  fail if METRIC grows by more than PERCENT; METRIC is\n";
+		std::cout<<"                               median, mean or a percentile such as p90 or p99.9.\n";
+		std::cout<<"                               Can be repeated, the default is median:5\n";
+		std::cout<<"  -s, --series NAME            check only this series, can be repeated\n";
+		std::cout<<"  --min-samples N              skip series with fewer samples (default 1)\n";
+		std::cout<<"  --allow-missing              do not fail if a baseline series is missing\n";
+		std::cout<<"  -h, --help                   show this help\n";
+	}
+
+	bool parseMetric(const std::string& text, Metric& metric)
+	{
+		std::size_t colon=text.find(':');
+		metric.name=text.substr(0, colon);
+		if(colon!=std::string::npos){
+			char* end=nullptr;
+			metric.threshold=std::strtod(text.c_str()+colon+1, &end);
+			if(*end=='%'){
+				end++;
+			}
+			if(*end!='\0' || end==text.c_str()+colon+1){
+				return false;
+			}
+		}
+
+		if(metric.name=="median"){
+			metric.quantile=0.5;
+		}
+		else if(metric.name=="mean"){
+			metric.quantile=-1;
+		}
+		else if(metric.name.size()>1 && metric.name[0]=='p'){
+			char* end=nullptr;
+			double percentile=std::strtod(metric.name.c_str()+1, &end);
+			if(*end!='\0' || percentile<0 || percentile>100){
+				return false;
+			}
+			metric.quantile=percentile/100;
+		}
+		else{
+			return false;
+		}
+		return true;
+	}
+
+	bool parseOptions(int argc, char** argv, Options& options)
+	{
+		std::vector<std::string> files;
+		for(int i=1; i<argc; i++){
+			std::string arg=argv[i];
+			bool hasValue=i+1<argc;
+			if(arg=="-h" || arg=="--help"){
+				return false;
+			}
+			else if((arg=="-m" || arg=="--metric") && hasValue){
+				Metric metric;
+				if(!parseMetric(argv[++i], metric)){
+					std::cout<<"Invalid metric: "<<argv[i]<<"\n";
+					return false;
+				}
+				options.metrics.push_back(metric);
+			}
+			else if((arg=="-s" || arg=="--series") && hasValue){
+				options.series.push_back(argv[++i]);
+			}
+			else if(arg=="--min-samples" && hasValue){
+				options.minSamples=std::strtoull(argv[++i], nullptr, 10);
+			}
+			else if(arg=="--allow-missing"){
+				options.allowMissing=true;
+			}
+			else if(!arg.empty() && arg[0]=='-'){
+				std::cout<<"Unknown option: "<<arg<<"\n";
+				return false;
+			}
+			else{
+				files.push_back(arg);
+			}
+		}
+
+		if(files.size()<2){
+			return false;
+		}
+
+		options.baseline=files.front();
+		options.candidates.assign(files.begin()+1, files.end());
+		if(options.metrics.empty()){
+			options.metrics.push_back(Metric{"median", 0.5, 5});
+		}
+		return true;
+	}
+
+	double evaluate(const tprofiler::LogHistogram& histogram, const Metric& metric)
+	{
+		return metric.quantile<0 ? histogram.mean() : histogram.quantile(metric.quantile);
+	}
+}
+
+//====================================================================
+
+int main(int argc, char** argv)
+{
+	Options options;
+	if(!parseOptions(argc, argv, options)){
+		usage();
+		return EXIT_ERROR;
+	}
+
+	SeriesSummaries baseline, candidate;
+	try{
+		baseline.beginFile(options.baseline);
+		tprofiler::parseDataSetFile(options.baseline, baseline);
+		for(const std::string& path : options.candidates){
+			candidate.beginFile(path);
+			tprofiler::parseDataSetFile(path, candidate);
+		}
+	}
+	catch(const std::exception& e){
+		std::cout<<"Error: "<<e.what()<<"\n";
+		return EXIT_ERROR;
+	}
+
+	// times in other units cannot be compared, rates and labels are not gated
+	std::string units=baseline.files().front().timeUnits;
+	std::vector<FileInfo> files=baseline.files();
+	files.insert(files.end(), candidate.files().begin(), candidate.files().end());
+	for(const FileInfo& file : files){
+		if(file.timeUnits!=units){
+			std::cout<<"Error: "<<file.path<<" has times in '"<<file.timeUnits<<"', the baseline in '"<<units<<"'\n";
+			return EXIT_ERROR;
+		}
+		if(!file.workUnits.empty()){
+			std::cout<<"Error: "<<file.path<<" is a throughput dataset ("<<file.workUnits<<"), only elapsed times are gated\n";
+			return EXIT_ERROR;
+		}
+		if(!file.labelledSeries.empty()){
+			std::cout<<"Error: series '"<<file.labelledSeries<<"' of "<<file.path<<" has labels, labelled series are not gated\n";
+			return EXIT_ERROR;
+		}
+	}
+
+	std::vector<std::string> names=options.series.empty() ? baseline.names() : options.series;
+
+	std::cout<<std::left<<std::setw(28)<<"series"<<std::right<<std::setw(8)<<"metric";
+	std::cout<<std::setw(14)<<"baseline"<<std::setw(14)<<"candidate"<<std::setw(10)<<"change"<<std::setw(8)<<"limit"<<"  status\n";
+
+	int status=EXIT_PASS;
+	for(const std::string& name : names){
+		const tprofiler::LogHistogram* before=baseline.find(name);
+		const tprofiler::LogHistogram* after=candidate.find(name);
+		if(!before || !after){
+			bool missingIsFailure=!options.allowMissing || !before;
+			std::cout<<std::left<<std::setw(28)<<name<<std::right<<"  missing from "<<(before ? "candidate" : "baseline");
+			std::cout<<(missingIsFailure ? "  FAIL\n" : "  skipped\n");
+			if(missingIsFailure){
+				status=EXIT_REGRESSION;
+			}
+			continue;
+		}
+
+		if(before->count()<options.minSamples || after->count()<options.minSamples){
+			std::cout<<std::left<<std::setw(28)<<name<<std::right<<"  too few samples ("<<before->count()<<", "<<after->count()<<")  skipped\n";
+			continue;
+		}
+
+		for(const Metric& metric : options.metrics){
+			double b=evaluate(*before, metric);
+			double c=evaluate(*after, metric);
+			double change=b!=0 ? 100*(c-b)/b : 0;
+			bool regression=change>metric.threshold;
+			if(regression){
+				status=EXIT_REGRESSION;
+			}
+
+			std::cout<<std::left<<std::setw(28)<<name<<std::right<<std::setw(8)<<metric.name;
+			std::cout<<std::setprecision(5)<<std::setw(14)<<b<<std::setw(14)<<c;
+			std::cout<<std::fixed<<std::setprecision(2)<<std::showpos<<std::setw(9)<<change<<"%";
+			std::cout<<std::noshowpos<<std::setprecision(1)<<std::setw(7)<<metric.threshold<<"%";
+			std::cout<<std::defaultfloat<<(regression ? "  FAIL" : "  ok")<<"\n";
+		}
+	}
+
+	if(!units.empty()){
+		std::cout<<"(times in "<<units<<")\n";
+	}
+	std::cout<<(status==EXIT_PASS ? "PASS" : "REGRESSION")<<"\n";
+	return status;
+}
@@ -0,0 +1,421 @@
+/*********************************************************************
+* AsyncProfiler times logical operations that hop between threads:   *
+* coroutines, callback chains, tasks of an executor.                 *
+*                                                                    *
+* An AsyncSpan is the handle of one operation. It is moved with the  *
+* operation, across suspension points and threads. It is told when  *
+* the operation stops running and when it resumes, so the latency    *
+* of the operation is split into the time it ran, in segments each   *
+* on one thread, and the time it spent suspended.                    *
+*                                                                    *
+* Version: 1.0                                                       *
+* Date:    16-10-2026                                                *
+* Author:  Dan Machado                                               *
+**********************************************************************/
+#ifndef TIME_PROFILER_ASYNC_SPAN_H
+#define TIME_PROFILER_ASYNC_SPAN_H
+
+#include <mutex>
+#include <thread>
+#include <utility>
+
+#include <time.h>
+
+#if defined(__cpp_impl_coroutine) && __has_include(<coroutine>)
+	#include <coroutine>
+	#define TPROFILER_COROUTINES
+#endif
+
+#include "time_profiler.h"
+
+//====================================================================
+
+namespace tprofiler
+{
+
+template<typename TM>
+class AsyncProfiler;
+
+/*
+ * Only one thread uses a span at a time, the one the operation runs
+ * on: handing the operation over to another thread hands the span
+ * over too. Calls out of order, resume() while running or suspend()
+ * while suspended, are ignored.
+ *
+ * */
+template<typename TM>
+class AsyncSpan
+{
+	public:
+		AsyncSpan()=default;
+		AsyncSpan(const AsyncSpan&)=delete;
+		AsyncSpan& operator=(const AsyncSpan&)=delete;
+
+		AsyncSpan(AsyncSpan&& span) noexcept
+		{
+			*this=std::move(span);
+		}
+
+		/*
+		 * The span replaced is finished first.
+		 *
+		 * */
+		AsyncSpan& operator=(AsyncSpan&& span) noexcept
+		{
+			if(this!=&span){
+				finish();
+				m_profiler=std::exchange(span.m_profiler, nullptr);
+				m_begin=span.m_begin;
+				m_mark=span.m_mark;
+				m_cpuMark=span.m_cpuMark;
+				m_running=span.m_running;
+				m_suspended=span.m_suspended;
+				m_cpu=span.m_cpu;
+				m_segments=std::move(span.m_segments);
+				m_thread=span.m_thread;
+				m_hops=span.m_hops;
+				m_isRunning=span.m_isRunning;
+			}
+			return *this;
+		}
+
+		~AsyncSpan()
+		{
+			finish();
+		}
+
+		/*
+		 * The operation stops running on this thread: it awaits I/O, a
+		 * timer, another task...
+		 *
+		 * */
+		void suspend();
+
+		/*
+		 * The operation runs again, on the calling thread.
+		 *
+		 * */
+		void resume();
+
+		/*
+		 * Record the span, done by the destructor otherwise. A span
+		 * finished while suspended counts the suspension up to now.
+		 *
+		 * */
+		void finish();
+
+		bool active() const
+		{
+			return m_profiler!=nullptr;
+		}
+
+	private:
+		friend class AsyncProfiler<TM>;
+
+		typedef std::chrono::high_resolution_clock clock;
+
+		AsyncProfiler<TM>* m_profiler{nullptr};
+		clock::time_point m_begin{};
+		clock::time_point m_mark{};        // of the last suspend() or resume()
+		std::int64_t m_cpuMark{0};         // thread CPU time at the last resume(), ns
+		clock::duration m_running{0};
+		clock::duration m_suspended{0};
+		std::int64_t m_cpu{0};             // ns
+		std::vector<clock::duration> m_segments{};
+		std::thread::id m_thread{};
+		std::uint32_t m_hops{0};
+		bool m_isRunning{false};
+
+		explicit AsyncSpan(AsyncProfiler<TM>* profiler)
+		: m_profiler(profiler)
+		, m_begin(clock::now())
+		, m_mark(m_begin)
+		, m_cpuMark(threadCpuTime())
+		, m_thread(std::this_thread::get_id())
+		, m_isRunning(true)
+		{
+		}
+
+		static std::int64_t threadCpuTime()
+		{
+			timespec now;
+			::clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now);
+			return static_cast<std::int64_t>(now.tv_sec)*1000000000+now.tv_nsec;
+		}
+};
+
+//--------------------------------------------------------------------
+
+/*
+ * Example:
+ *
+ * tprofiler::AsyncProfiler<std::chrono::microseconds> requests("request", "#4363d8", "/tmp");
+ *
+ * auto span=requests.begin();
+ * span.suspend();
+ * database.query(sql, [span=std::move(span)](Rows rows) mutable {
+ *    span.resume();
+ *    render(rows);
+ * }); // the span is finished when the callback is destroyed
+ *
+ * In a coroutine, each co_await wrapped in tprofiler::suspending()
+ * suspends and resumes the span:
+ *
+ * auto span=requests.begin();
+ * Rows rows=co_await tprofiler::suspending(span, database.query(sql));
+ * render(rows);
+ *
+ * */
+template<typename TM>
+class AsyncProfiler
+{
+	public:
+		/*
+		 * Constructor
+		 *
+		 * @param name a string to identify the dataset
+		 * @param colour the colour of the latency series, the others
+		 *        are lighter shades of it
+		 * @param outputDir path to the directory where the js file will
+		 *        be created. If empty no file is created.
+		 * */
+		AsyncProfiler(const char* name, const char* colour, const char* outputDir="")
+		: m_name(name)
+		, m_colour(colour)
+		, m_outputDir(outputDir)
+		{
+		}
+
+		AsyncProfiler(const AsyncProfiler&)=delete;
+		AsyncProfiler& operator=(const AsyncProfiler&)=delete;
+
+		/*
+		 * Spans still alive must be finished before.
+		 *
+		 * */
+		~AsyncProfiler()
+		{
+			flush();
+		}
+
+		/*
+		 * Start an operation, running on the calling thread. Without
+		 * ENABLE_STOPWATCH the span records nothing.
+		 *
+		 * */
+		AsyncSpan<TM> begin()
+		{
+			#ifdef ENABLE_STOPWATCH
+			return AsyncSpan<TM>(this);
+			#else
+			return AsyncSpan<TM>();
+			#endif
+		}
+
+		/*
+		 * Number of spans finished and not yet written.
+		 *
+		 * */
+		std::size_t spans() const
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			return m_latency.size();
+		}
+
+		/*
+		 * Write the spans finished so far, in one dataset, and forget
+		 * them:
+		 *  - "<name>" latency of every operation,
+		 *  - "<name> running" time it ran, all segments together,
+		 *  - "<name> cpu" CPU time of its threads while it ran,
+		 *  - "<name> suspended" time it waited,
+		 *  - "<name> segments" every segment it ran, one by one.
+		 *
+		 * */
+		void flush();
+
+	private:
+		typedef std::chrono::duration<double, typename TimeType<TM>::timePeriod> duration;
+
+		std::string m_name;
+		std::string m_colour;
+		std::string m_outputDir;
+		mutable std::mutex m_mutex{};
+		std::vector<double> m_latency{};
+		std::vector<double> m_running{};
+		std::vector<double> m_cpu{};
+		std::vector<double> m_suspended{};
+		std::vector<double> m_segments{};
+		std::uint64_t m_hops{0};
+
+		friend class AsyncSpan<TM>;
+
+		// spans are finished from any thread, only this locks
+		void record(const AsyncSpan<TM>& span, typename AsyncSpan<TM>::clock::time_point end);
+};
+
+//====================================================================
+
+template<typename TM>
+void AsyncSpan<TM>::suspend()
+{
+	if(m_profiler==nullptr || !m_isRunning){
+		return;
+	}
+	clock::time_point now=clock::now();
+	m_cpu+=threadCpuTime()-m_cpuMark;
+	m_running+=now-m_mark;
+	m_segments.push_back(now-m_mark);
+	m_mark=now;
+	m_isRunning=false;
+}
+
+//--------------------------------------------------------------------
+
+template<typename TM>
+void AsyncSpan<TM>::resume()
+{
+	if(m_profiler==nullptr || m_isRunning){
+		return;
+	}
+	clock::time_point now=clock::now();
+	m_suspended+=now-m_mark;
+	m_mark=now;
+	m_cpuMark=threadCpuTime();
+	if(std::this_thread::get_id()!=m_thread){
+		m_thread=std::this_thread::get_id();
+		m_hops++;
+	}
+	m_isRunning=true;
+}
+
+//--------------------------------------------------------------------
+
+template<typename TM>
+void AsyncSpan<TM>::finish()
+{
+	if(m_profiler==nullptr){
+		return;
+	}
+	clock::time_point now=clock::now();
+	if(m_isRunning){
+		m_cpu+=threadCpuTime()-m_cpuMark;
+		m_running+=now-m_mark;
+		m_segments.push_back(now-m_mark);
+	}
+	else{
+		m_suspended+=now-m_mark;
+	}
+	m_profiler->record(*this, now);
+	m_profiler=nullptr;
+	m_segments.clear();
+}
+
+//--------------------------------------------------------------------
+
+template<typename TM>
+void AsyncProfiler<TM>::record(const AsyncSpan<TM>& span, typename AsyncSpan<TM>::clock::time_point end)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_latency.push_back(duration(end-span.m_begin).count());
+	m_running.push_back(duration(span.m_running).count());
+	m_cpu.push_back(duration(std::chrono::nanoseconds(span.m_cpu)).count());
+	m_suspended.push_back(duration(span.m_suspended).count());
+	for(const auto& segment : span.m_segments){
+		m_segments.push_back(duration(segment).count());
+	}
+	m_hops+=span.m_hops;
+}
+
+//--------------------------------------------------------------------
+
+template<typename TM>
+void AsyncProfiler<TM>::flush()
+{
+	// taken under the lock, written without it: finish() never waits
+	// for the file
+	std::vector<double> latency, running, cpu, suspended, segments;
+	std::uint64_t hops;
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		if(m_latency.empty() || m_outputDir.empty()){
+			return;
+		}
+		latency.swap(m_latency);
+		running.swap(m_running);
+		cpu.swap(m_cpu);
+		suspended.swap(m_suspended);
+		segments.swap(m_segments);
+		hops=m_hops;
+		m_hops=0;
+	}
+
+	DataSetWriter<TM> writer(m_outputDir.c_str(), m_name.c_str());
+	writer.addSeries(m_name.c_str(), m_colour.c_str(), latency);
+	writer.addSeries((m_name+" running").c_str(), lighterColour(m_colour, 0.25).c_str(), running);
+	writer.addSeries((m_name+" cpu").c_str(), lighterColour(m_colour, 0.45).c_str(), cpu);
+	writer.addSeries((m_name+" suspended").c_str(), lighterColour(m_colour, 0.65).c_str(), suspended);
+	writer.addSeries((m_name+" segments").c_str(), lighterColour(m_colour, 0.8).c_str(), segments);
+	writer.addHeader("spans", std::to_string(latency.size()));
+	writer.addHeader("threadHops", std::to_string(hops));
+}
+
+//====================================================================
+
+#ifdef TPROFILER_COROUTINES
+
+/*
+ * An awaiter suspending the span while the coroutine awaits, and
+ * resuming it on whichever thread the coroutine is resumed.
+ *
+ * */
+template<typename TM, typename A>
+class SuspendingAwaiter
+{
+	public:
+		SuspendingAwaiter(AsyncSpan<TM>& span, A&& awaiter)
+		: m_span(span)
+		, m_awaiter(std::forward<A>(awaiter))
+		{
+		}
+
+		bool await_ready()
+		{
+			return m_awaiter.await_ready();
+		}
+
+		template<typename P>
+		decltype(auto) await_suspend(std::coroutine_handle<P> coroutine)
+		{
+			m_span.suspend();
+			return m_awaiter.await_suspend(coroutine);
+		}
+
+		decltype(auto) await_resume()
+		{
+			m_span.resume();
+			return m_awaiter.await_resume();
+		}
+
+	private:
+		AsyncSpan<TM>& m_span;
+		A m_awaiter;
+};
+
+/*
+ * @param awaiter an awaiter, with await_ready(), await_suspend() and
+ *        await_resume()
+ * */
+template<typename TM, typename A>
+SuspendingAwaiter<TM, A> suspending(AsyncSpan<TM>& span, A&& awaiter)
+{
+	return SuspendingAwaiter<TM, A>(span, std::forward<A>(awaiter));
+}
+
+#endif
+
+//====================================================================
+
+}
+
+#endif
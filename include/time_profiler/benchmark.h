@@ -0,0 +1,310 @@
+/*********************************************************************
+* Benchmark is a microbenchmark runner built on TimeProfiler.        *
+*                                                                    *
+* Each registered callable is warmed up, its batch size is chosen    *
+* so a batch lasts long enough to be measured reliably, and every    *
+* batch is recorded through a TimeProfiler. All the implementations  *
+* end up as series of one dataset file for the visualizer.           *
+*                                                                    *
+* Version: 1.0                                                       *
+* Date:    16-10-2026                                                *
+* Author:  Dan Machado                                               *
+**********************************************************************/
+#ifndef TIME_PROFILER_BENCHMARK_H
+#define TIME_PROFILER_BENCHMARK_H
+
+#include <functional>
+#include <memory>
+#include <type_traits>
+
+#include "time_profiler.h"
+#include "statistics.h"
+#include "repetition_controller.h"
+
+//====================================================================
+
+namespace tprofiler
+{
+	/*
+	 * Prevent the compiler from optimizing away the computation of value.
+	 *
+	 * */
+	template<typename T>
+	inline void doNotOptimize(T const& value)
+	{
+		asm volatile("" : : "r,m"(value) : "memory");
+	}
+
+	/*
+	 * Force the compiler to assume all memory may have been read and
+	 * written, so stores cannot be elided.
+	 *
+	 * */
+	inline void clobberMemory()
+	{
+		asm volatile("" : : : "memory");
+	}
+
+	struct BenchmarkSettings
+	{
+		double warmupTime{0.1};     // seconds running the task before measuring
+		double minBatchTime{0.005}; // seconds, a batch of iterations lasts at least this
+		int repetitions{30};        // batches recorded per task
+		double outlierFactor{1.5};  // Tukey's k, 0 keeps every sample
+		bool adaptive{false};       // if true, stoppingRule replaces repetitions
+		StoppingRule stoppingRule{};
+	};
+
+	inline namespace internal
+	{
+		inline double secondsSince(std::chrono::steady_clock::time_point start)
+		{
+			return std::chrono::duration<double>(std::chrono::steady_clock::now()-start).count();
+		}
+
+		/*
+		 * Wrap a task in a loop running it a given number of times, with
+		 * its result (if any) kept alive.
+		 *
+		 * */
+		template<typename F>
+		auto makeBatchRunner(F task)
+		{
+			return [task](long long iterations) mutable {
+				for(long long i=0; i<iterations; i++){
+					if constexpr(std::is_void<std::invoke_result_t<F&>>::value){
+						task();
+					}
+					else{
+						doNotOptimize(task());
+					}
+					clobberMemory();
+				}
+			};
+		}
+
+		/*
+		 * Run the batch for the warm-up time while growing the batch size 
+		 * until one batch lasts at least minBatchTime.
+		 *
+		 * @param runBatch callable running the task a given number of times
+		 * @return the number of iterations per batch
+		 * */
+		template<typename B>
+		long long warmUp(B& runBatch, const BenchmarkSettings& settings)
+		{
+			auto warmupStart=std::chrono::steady_clock::now();
+			long long iterations=1;
+			while(true){
+				auto batchStart=std::chrono::steady_clock::now();
+				runBatch(iterations);
+				double batchTime=secondsSince(batchStart);
+
+				if(batchTime<settings.minBatchTime){
+					double factor=batchTime>0 ? 1.4*settings.minBatchTime/batchTime : 10;
+					iterations=static_cast<long long>(iterations*std::clamp(factor, 2.0, 10.0));
+					continue;
+				}
+
+				if(secondsSince(warmupStart)>=settings.warmupTime){
+					break;
+				}
+			}
+			return iterations;
+		}
+
+		/*
+		 * Record batches through the profiler, either a fixed number of 
+		 * repetitions or until the stopping rule is satisfied, then
+		 * discard outliers.
+		 *
+		 * @param confidence set to the achieved confidence (JSON) if adaptive
+		 * @return number of samples rejected as outliers
+		 * */
+		template<typename TM, typename B>
+		std::size_t measureBatches(TimeProfiler<TM>& profiler, B& runBatch, long long iterations, const BenchmarkSettings& settings, std::string& confidence)
+		{
+			if(settings.adaptive){
+				RepetitionController controller(settings.stoppingRule);
+				while(controller.keepGoing(profiler.samples())){
+					profiler.start();
+					runBatch(iterations);
+					profiler.takeBatchSample(iterations);
+				}
+				confidence=controller.toJson();
+			}
+			else{
+				for(int i=0; i<settings.repetitions; i++){
+					profiler.start();
+					runBatch(iterations);
+					profiler.takeBatchSample(iterations);
+				}
+			}
+
+			if(settings.outlierFactor>0 && profiler.samples().size()>3){
+				stats::Interval fences=stats::tukeyFences(profiler.samples(), settings.outlierFactor);
+				return profiler.discardSamples(fences.lower, fences.upper);
+			}
+			return 0;
+		}
+	}
+
+//====================================================================
+
+/*
+ * Example:
+ *
+ * tprofiler::Benchmark<std::chrono::nanoseconds> bench("sort", "/tmp");
+ *
+ * bench.add("std::sort", "#4363d8", [&]{
+ *    auto v=input;
+ *    std::sort(v.begin(), v.end());
+ *    tprofiler::doNotOptimize(v.data());
+ * });
+ *
+ * bench.add("radix sort", "#f58231", [&]{
+ *    auto v=input;
+ *    radixSort(v);
+ *    return v.front();    // returned values are kept alive automatically
+ * });
+ *
+ * bench.run();
+ *
+ * Without ENABLE_STOPWATCH nothing is recorded, as with TimeProfiler:
+ * the tasks still run but no sample or dataset file is produced. The
+ * sweeps built on it (scaling, scalability, cache) behave the same.
+ *
+ * */
+
+template<typename TM>
+class Benchmark
+{
+	public:
+		/*
+		 * Constructor
+		 *
+		 * @param name a string to identify the dataset file
+		 * @param outputDir path to the directory where the js file with all
+		 *        the series will be created. If empty no file is created.
+		 * @param settings warm-up, batch and outlier rejection settings
+		 * */
+		Benchmark(const char* name, const char* outputDir="", const BenchmarkSettings& settings=BenchmarkSettings())
+		: m_name(name)
+		, m_outputDir(outputDir)
+		, m_settings(settings)
+		{
+		}
+
+		/*
+		 * Register an implementation to compare.
+		 *
+		 * @param name a string to identify the series
+		 * @param colour the colour of the series in the visualizer
+		 * @param task callable with no arguments, its result (if any) is
+		 *        passed to doNotOptimize
+		 * */
+		template<typename F>
+		Benchmark& add(const char* name, const char* colour, F task);
+
+		/*
+		 * Run every registered task, print a summary and write the dataset.
+		 *
+		 * */
+		void run();
+
+	private:
+		struct Case
+		{
+			std::unique_ptr<TimeProfiler<TM>> profiler;
+			std::function<void(long long)> runBatch;
+			long long iterations{1};
+			std::size_t rejected{0};
+			std::string confidence{};
+		};
+
+		std::vector<Case> m_cases{};
+		std::string m_name;
+		std::string m_outputDir;
+		BenchmarkSettings m_settings;
+
+		void report() const;
+};
+
+//--------------------------------------------------------------------
+
+template<typename TM>
+template<typename F>
+Benchmark<TM>& Benchmark<TM>::add(const char* name, const char* colour, F task)
+{
+	Case benchCase;
+	benchCase.profiler=std::make_unique<TimeProfiler<TM>>(name, colour);
+	benchCase.runBatch=makeBatchRunner(std::move(task));
+	m_cases.push_back(std::move(benchCase));
+	return *this;
+}
+
+//--------------------------------------------------------------------
+
+template<typename TM>
+void Benchmark<TM>::run()
+{
+	for(Case& benchCase : m_cases){
+		benchCase.iterations=warmUp(benchCase.runBatch, m_settings);
+		benchCase.rejected=measureBatches(*benchCase.profiler, benchCase.runBatch, benchCase.iterations, m_settings, benchCase.confidence);
+	}
+
+	report();
+
+	if(m_outputDir.empty()){
+		return;
+	}
+
+	DataSetWriter<TM> writer(m_outputDir.c_str(), m_name.c_str());
+	std::ostringstream summary;
+	summary<<"[";
+	for(std::size_t i=0; i<m_cases.size(); i++){
+		const Case& benchCase=m_cases[i];
+		writer.addSeries(*benchCase.profiler);
+		if(i>0){
+			summary<<", ";
+		}
+		summary<<"{\"series\": ";
+		writeJsonString(summary, benchCase.profiler->name());
+		summary<<", \"iterations\": "<<benchCase.iterations;
+		summary<<", \"rejected\": "<<benchCase.rejected;
+		summary<<", \"median\": "<<stats::median(benchCase.profiler->samples());
+		if(!benchCase.confidence.empty()){
+			summary<<", \"confidence\": "<<benchCase.confidence;
+		}
+		summary<<"}";
+	}
+	summary<<"]";
+	writer.addHeader("benchmark", summary.str());
+}
+
+//--------------------------------------------------------------------
+
+template<typename TM>
+void Benchmark<TM>::report() const
+{
+	std::ios_base::fmtflags f(std::cout.flags());
+	std::cout<<std::left<<std::setw(24)<<"task"<<std::right;
+	std::cout<<std::setw(12)<<"iterations"<<std::setw(10)<<"samples"<<std::setw(10)<<"rejected";
+	std::cout<<std::setw(14)<<"median"<<std::setw(14)<<"p90"<<"\n";
+
+	for(const Case& benchCase : m_cases){
+		const std::vector<double>& samples=benchCase.profiler->samples();
+		std::cout<<std::left<<std::setw(24)<<benchCase.profiler->name()<<std::right;
+		std::cout<<std::setw(12)<<benchCase.iterations<<std::setw(10)<<samples.size();
+		std::cout<<std::setw(10)<<benchCase.rejected<<std::fixed<<std::setprecision(3);
+		std::cout<<std::setw(14)<<stats::median(samples)<<std::setw(14)<<stats::quantile(samples, 0.9);
+		std::cout<<" "<<TimeType<TM>::timeUnit<<"\n";
+	}
+	std::cout.flags(f);
+}
+
+//====================================================================
+
+}
+
+#endif
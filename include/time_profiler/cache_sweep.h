@@ -0,0 +1,269 @@
+/*********************************************************************
+* CacheSweep runs a kernel over growing working sets.                *
+*                                                                    *
+* The time per element is recorded for working sets from a few KB to *
+* several GB, and the cache sizes read from sysfs annotate where the *
+* working set leaves L1, L2, L3 and goes to DRAM.                    *
+*                                                                    *
+* Version: 1.0                                                       *
+* Date:    16-10-2026                                                *
+* Author:  Dan Machado                                               *
+**********************************************************************/
+#ifndef TIME_PROFILER_CACHE_SWEEP_H
+#define TIME_PROFILER_CACHE_SWEEP_H
+
+#include "benchmark.h"
+
+//====================================================================
+
+namespace tprofiler
+{
+	struct CacheLevel
+	{
+		std::string name{};   // L1d, L2, L3...
+		std::size_t bytes{0};
+	};
+
+	inline namespace internal
+	{
+		/*
+		 * Parse sizes such as "48K", "2048K", "32M".
+		 *
+		 * */
+		inline std::size_t parseSize(const std::string& size)
+		{
+			if(size.empty()){
+				return 0;
+			}
+
+			std::size_t value=std::strtoull(size.c_str(), nullptr, 10);
+			switch(size.back()){
+				case 'K':
+					return value<<10;
+				case 'M':
+					return value<<20;
+				case 'G':
+					return value<<30;
+			}
+			return value;
+		}
+
+		inline std::string formatBytes(std::size_t bytes)
+		{
+			const char* units[]={"B", "KB", "MB", "GB", "TB"};
+			int unit=0;
+			double value=static_cast<double>(bytes);
+			while(value>=1024 && unit<4){
+				value/=1024;
+				unit++;
+			}
+			std::ostringstream text;
+			text<<std::setprecision(value<10 ? 2 : 3)<<value<<units[unit];
+			return text.str();
+		}
+	}
+
+	/*
+	 * Data and unified caches of cpu0, from the smallest to the largest.
+	 *
+	 * */
+	inline std::vector<CacheLevel> readCacheLevels()
+	{
+		std::vector<CacheLevel> levels;
+		for(int index=0; ; index++){
+			std::string dir="/sys/devices/system/cpu/cpu0/cache/index"+std::to_string(index)+"/";
+			std::string level=readFirstLine(dir+"level");
+			if(level.empty()){
+				break;
+			}
+
+			std::string type=readFirstLine(dir+"type");
+			if(type=="Instruction"){
+				continue;
+			}
+
+			CacheLevel cache;
+			cache.name="L"+level+(type=="Data" ? "d" : "");
+			cache.bytes=parseSize(readFirstLine(dir+"size"));
+			if(cache.bytes>0){
+				levels.push_back(cache);
+			}
+		}
+
+		std::sort(levels.begin(), levels.end(), [](const CacheLevel& a, const CacheLevel& b){
+			return a.bytes<b.bytes;
+		});
+		return levels;
+	}
+
+//====================================================================
+
+/*
+ * Example:
+ *
+ * tprofiler::CacheSweep<std::chrono::nanoseconds> sweep("sum", "#4363d8", "/tmp");
+ *
+ * sweep.run([](std::uint64_t* data, std::size_t count){
+ *    std::uint64_t sum=0;
+ *    for(std::size_t i=0; i<count; i++){
+ *       sum+=data[i];
+ *    }
+ *    return sum;
+ * }, 4<<10, 1ULL<<30);
+ *
+ * */
+
+template<typename TM, typename T=std::uint64_t>
+class CacheSweep
+{
+	public:
+		/*
+		 * Constructor
+		 *
+		 * @param name a string to identify the dataset
+		 * @param colour the colour of the curves
+		 * @param outputDir path to the directory where the js file will
+		 *        be created. If empty no file is created.
+		 * @param settings warm-up, batch and repetition settings per size
+		 * */
+		CacheSweep(const char* name, const char* colour, const char* outputDir="", const BenchmarkSettings& settings=BenchmarkSettings())
+		: m_name(name)
+		, m_colour(colour)
+		, m_outputDir(outputDir)
+		, m_settings(settings)
+		, m_caches(readCacheLevels())
+		{
+		}
+
+		/*
+		 * Run the kernel over working sets from minBytes to maxBytes.
+		 *
+		 * @param kernel callable taking (T* data, std::size_t count), going
+		 *        once over the count elements
+		 * @param minBytes smallest working set
+		 * @param maxBytes largest working set, the buffer is allocated once
+		 * @param stepsPerDoubling working sets between two powers of two
+		 * */
+		template<typename F>
+		void run(F kernel, std::size_t minBytes=4<<10, std::size_t maxBytes=std::size_t(1)<<30, int stepsPerDoubling=2);
+
+		const std::vector<CacheLevel>& cacheLevels() const
+		{
+			return m_caches;
+		}
+
+	private:
+		std::string m_name;
+		std::string m_colour;
+		std::string m_outputDir;
+		BenchmarkSettings m_settings;
+		std::vector<CacheLevel> m_caches;
+
+		std::string annotation(std::size_t previous, std::size_t bytes) const;
+};
+
+//--------------------------------------------------------------------
+
+/*
+ * Name of the level the working set has just outgrown, if any.
+ *
+ * */
+template<typename TM, typename T>
+std::string CacheSweep<TM, T>::annotation(std::size_t previous, std::size_t bytes) const
+{
+	std::string name;
+	for(std::size_t i=0; i<m_caches.size(); i++){
+		if(previous<=m_caches[i].bytes && bytes>m_caches[i].bytes){
+			name=(i+1<m_caches.size()) ? m_caches[i+1].name : "DRAM";
+		}
+	}
+	return name;
+}
+
+//--------------------------------------------------------------------
+
+template<typename TM, typename T>
+template<typename F>
+void CacheSweep<TM, T>::run(F kernel, std::size_t minBytes, std::size_t maxBytes, int stepsPerDoubling)
+{
+	const std::size_t capacity=std::max<std::size_t>(maxBytes/sizeof(T), 1);
+	std::unique_ptr<T[]> buffer(new T[capacity]);
+	for(std::size_t i=0; i<capacity; i++){
+		buffer[i]=static_cast<T>(i); // touch every page before measuring
+	}
+
+	std::vector<double> sizes, medians, p10, p90;
+	std::vector<std::string> labels;
+	const double factor=std::pow(2.0, 1.0/std::max(stepsPerDoubling, 1));
+	std::size_t previous=0;
+	for(double bytes=static_cast<double>(std::max(minBytes, sizeof(T))); bytes<=maxBytes*1.0001; bytes*=factor){
+		std::size_t count=static_cast<std::size_t>(bytes)/sizeof(T);
+		std::size_t workingSet=count*sizeof(T);
+		if(workingSet==previous){
+			continue;
+		}
+
+		T* data=buffer.get();
+		auto runBatch=makeBatchRunner([&kernel, data, count]{ return kernel(data, count); });
+		TimeProfiler<TM> profiler(m_name.c_str(), m_colour.c_str());
+		long long iterations=warmUp(runBatch, m_settings);
+
+		// time per element instead of time per pass over the working set
+		long long elements=iterations*static_cast<long long>(count);
+		for(int i=0; i<m_settings.repetitions; i++){
+			profiler.start();
+			runBatch(iterations);
+			profiler.takeBatchSample(elements);
+		}
+
+		std::vector<double> sorted=profiler.samples();
+		std::sort(sorted.begin(), sorted.end());
+		sizes.push_back(static_cast<double>(workingSet));
+		p10.push_back(stats::sortedQuantile(sorted, 0.1));
+		medians.push_back(stats::sortedQuantile(sorted, 0.5));
+		p90.push_back(stats::sortedQuantile(sorted, 0.9));
+
+		std::string label=formatBytes(workingSet);
+		std::string level=annotation(previous, workingSet);
+		if(!level.empty()){
+			label.append(" ").append(level);
+		}
+		labels.push_back(label);
+		previous=workingSet;
+	}
+
+	std::ios_base::fmtflags f(std::cout.flags());
+	for(std::size_t i=0; i<sizes.size(); i++){
+		std::cout<<std::setw(16)<<labels[i]<<std::setw(14)<<std::fixed<<std::setprecision(3)<<medians[i];
+		std::cout<<" "<<TimeType<TM>::timeUnit<<"/element\n";
+	}
+	std::cout.flags(f);
+
+	if(m_outputDir.empty()){
+		return;
+	}
+
+	DataSetWriter<TM> writer(m_outputDir.c_str(), m_name.c_str());
+	writer.setXAxis("Working set (log scale)", sizes, labels);
+	writer.setYTitle((std::string("Time per element (")+TimeType<TM>::timeUnit+")").c_str());
+	writer.addSeries((m_name+" median").c_str(), m_colour.c_str(), medians);
+	writer.addSeries((m_name+" p10").c_str(), lighterColour(m_colour, 0.5).c_str(), p10);
+	writer.addSeries((m_name+" p90").c_str(), lighterColour(m_colour, 0.5).c_str(), p90);
+
+	std::ostringstream caches;
+	caches<<"[";
+	for(std::size_t i=0; i<m_caches.size(); i++){
+		caches<<(i>0 ? ", " : "")<<"{\"name\": ";
+		writeJsonString(caches, m_caches[i].name);
+		caches<<", \"bytes\": "<<m_caches[i].bytes<<"}";
+	}
+	caches<<"]";
+	writer.addHeader("cacheLevels", caches.str());
+	writer.addHeader("elementBytes", std::to_string(sizeof(T)));
+}
+
+//====================================================================
+
+}
+
+#endif
@@ -0,0 +1,237 @@
+/*********************************************************************
+* A/B comparison of two runs.                                        *
+*                                                                    *
+* The series of a baseline and a candidate dataset are matched by    *
+* name and compared: change of the median and of the percentiles, a  *
+* Mann-Whitney U test and a bootstrap confidence interval of the     *
+* median difference decide whether the change is significant.        *
+*                                                                    *
+* Version: 1.0                                                       *
+* Date:    16-10-2026                                                *
+* Author:  Dan Machado                                               *
+**********************************************************************/
+#ifndef TIME_PROFILER_COMPARISON_H
+#define TIME_PROFILER_COMPARISON_H
+
+#include "time_profiler.h"
+#include "statistics.h"
+#include "dataset_reader.h"
+
+//====================================================================
+
+namespace tprofiler
+{
+	struct ComparisonSettings
+	{
+		double alpha{0.05};          // significance level of the U test
+		double confidenceLevel{0.95};
+		double minimumChange{0.01};  // relative median change below which a change is noise
+		int resamples{2000};         // bootstrap resamples
+	};
+
+	struct Comparison
+	{
+		std::string name{};
+		std::size_t baselineCount{0};
+		std::size_t candidateCount{0};
+		double baselineMedian{0};
+		double candidateMedian{0};
+		stats::Estimate difference{};  // median(candidate)-median(baseline)
+		stats::RankTest test{};
+		std::vector<double> percentiles{};
+		std::vector<double> changes{};  // relative change at each percentile
+		bool significant{false};
+
+		/*
+		 * Relative change of the median, positive if the candidate is slower.
+		 *
+		 * */
+		double change() const
+		{
+			return baselineMedian!=0 ? difference.value/baselineMedian : 0;
+		}
+
+		/*
+		 * "slower", "faster" or "no significant change", for samples of
+		 * elapsed time (for rates a larger value is better).
+		 *
+		 * */
+		std::string verdict() const
+		{
+			if(!significant){
+				return "no significant change";
+			}
+			return difference.value>0 ? "slower" : "faster";
+		}
+	};
+
+//--------------------------------------------------------------------
+
+	/*
+	 * Compare two samples of elapsed times.
+	 *
+	 * The change is significant when the U test rejects equal
+	 * distributions, the confidence interval of the median difference
+	 * excludes zero and the median changes by at least minimumChange.
+	 * */
+	inline Comparison compareSamples(const std::string& name, const std::vector<double>& baseline, const std::vector<double>& candidate, const ComparisonSettings& settings=ComparisonSettings())
+	{
+		Comparison comparison;
+		comparison.name=name;
+		comparison.baselineCount=baseline.size();
+		comparison.candidateCount=candidate.size();
+		if(baseline.empty() || candidate.empty()){
+			return comparison;
+		}
+
+		std::vector<double> sortedBaseline=baseline;
+		std::vector<double> sortedCandidate=candidate;
+		std::sort(sortedBaseline.begin(), sortedBaseline.end());
+		std::sort(sortedCandidate.begin(), sortedCandidate.end());
+		comparison.baselineMedian=stats::sortedQuantile(sortedBaseline, 0.5);
+		comparison.candidateMedian=stats::sortedQuantile(sortedCandidate, 0.5);
+
+		comparison.percentiles={1, 5, 10, 20, 30, 40, 50, 60, 70, 80, 90, 95, 99};
+		for(double p : comparison.percentiles){
+			double before=stats::sortedQuantile(sortedBaseline, p/100);
+			double after=stats::sortedQuantile(sortedCandidate, p/100);
+			comparison.changes.push_back(before!=0 ? (after-before)/before : 0);
+		}
+
+		comparison.difference=stats::bootstrapMedianDifference(baseline, candidate, settings.confidenceLevel, settings.resamples);
+		comparison.test=stats::mannWhitneyU(baseline, candidate);
+
+		bool excludesZero=comparison.difference.lower>0 || comparison.difference.upper<0;
+		comparison.significant=comparison.test.pValue<settings.alpha && excludesZero
+			&& std::fabs(comparison.change())>=settings.minimumChange;
+		return comparison;
+	}
+
+	/*
+	 * Compare the series of two datasets with the same name. If each
+	 * dataset has a single series they are compared whatever their names.
+	 *
+	 * */
+	inline std::vector<Comparison> compareDataSets(const DataSet& baseline, const DataSet& candidate, const ComparisonSettings& settings=ComparisonSettings())
+	{
+		std::vector<Comparison> comparisons;
+		if(baseline.series.size()==1 && candidate.series.size()==1){
+			const Series& a=baseline.series.front();
+			const Series& b=candidate.series.front();
+			std::string name=a.name==b.name ? a.name : a.name+" vs "+b.name;
+			comparisons.push_back(compareSamples(name, a.data, b.data, settings));
+			return comparisons;
+		}
+
+		for(const Series& a : baseline.series){
+			for(const Series& b : candidate.series){
+				if(a.name==b.name){
+					comparisons.push_back(compareSamples(a.name, a.data, b.data, settings));
+					break;
+				}
+			}
+		}
+		return comparisons;
+	}
+
+	/*
+	 * Compare two series of the same dataset.
+	 *
+	 * @throws std::runtime_error if a series does not exist
+	 * */
+	inline Comparison compareSeries(const DataSet& dataSet, const std::string& baseline, const std::string& candidate, const ComparisonSettings& settings=ComparisonSettings())
+	{
+		const Series* a=nullptr;
+		const Series* b=nullptr;
+		for(const Series& series : dataSet.series){
+			if(series.name==baseline && !a){
+				a=&series;
+			}
+			else if(series.name==candidate && !b){
+				b=&series;
+			}
+		}
+		if(!a || !b){
+			throw std::runtime_error("no series named "+(a ? candidate : baseline));
+		}
+		return compareSamples(baseline+" vs "+candidate, a->data, b->data, settings);
+	}
+
+//--------------------------------------------------------------------
+
+	inline void printComparisons(std::ostream& out, const std::vector<Comparison>& comparisons, const std::string& timeUnits)
+	{
+		std::ios_base::fmtflags f(out.flags());
+		for(const Comparison& c : comparisons){
+			out<<c.name<<": "<<c.verdict()<<"\n";
+			out<<std::setprecision(4)<<"    median "<<c.baselineMedian<<" -> "<<c.candidateMedian<<" "<<timeUnits;
+			out<<std::showpos<<std::fixed<<std::setprecision(2)<<" ("<<100*c.change()<<"%)"<<std::noshowpos<<"\n";
+			out<<std::defaultfloat<<std::setprecision(4);
+			out<<"    difference CI ["<<c.difference.lower<<", "<<c.difference.upper<<"] "<<timeUnits;
+			out<<", Mann-Whitney p="<<c.test.pValue<<"\n";
+			out.flags(f);
+		}
+	}
+
+	/*
+	 * Write the comparisons as a dataset for the visualizer: one series
+	 * per comparison with the relative change (%) at each percentile, and
+	 * the verdicts in the "comparison" entry of the header.
+	 *
+	 * */
+	inline void writeComparisonDataSet(std::ostream& out, const std::vector<Comparison>& comparisons, const std::string& timeUnits)
+	{
+		static const char* colours[]={"#e6194b", "#3cb44b", "#4363d8", "#f58231", "#911eb4", "#42d4f4", "#f032e6", "#808000"};
+
+		std::ios_base::fmtflags f(out.flags());
+		out<<std::setprecision(10);
+		writeDataSetBegin(out);
+		for(std::size_t i=0; i<comparisons.size(); i++){
+			const Comparison& c=comparisons[i];
+			std::vector<double> changes;
+			for(double change : c.changes){
+				changes.push_back(100*change);
+			}
+
+			out<<(i>0 ? ",\n" : "")<<"{\"name\": ";
+			writeJsonString(out, c.name);
+			out<<", \"color\": \""<<colours[i%8]<<"\", \"data\":";
+			writeJsonArray(out, changes, changes.size());
+			out<<"}";
+		}
+
+		std::ostringstream fields;
+		fields<<"\"xTitle\": \"Percentile\", \"yTitle\": \"Change (%)\", \"x\": ";
+		std::vector<double> percentiles=comparisons.empty() ? std::vector<double>() : comparisons.front().percentiles;
+		writeJsonArray(fields, percentiles, percentiles.size());
+		fields<<", \"xLabels\": [";
+		for(std::size_t i=0; i<percentiles.size(); i++){
+			fields<<(i>0 ? ", " : "")<<"\"p"<<percentiles[i]<<"\"";
+		}
+		fields<<"]";
+
+		std::ostringstream verdicts;
+		verdicts<<std::setprecision(10)<<"[";
+		for(std::size_t i=0; i<comparisons.size(); i++){
+			const Comparison& c=comparisons[i];
+			verdicts<<(i>0 ? ", " : "")<<"{\"name\": ";
+			writeJsonString(verdicts, c.name);
+			verdicts<<", \"verdict\": \""<<c.verdict()<<"\", \"significant\": "<<(c.significant ? "true" : "false");
+			verdicts<<", \"baselineMedian\": "<<c.baselineMedian<<", \"candidateMedian\": "<<c.candidateMedian;
+			verdicts<<", \"change\": "<<c.change()<<", \"differenceLower\": "<<c.difference.lower<<", \"differenceUpper\": "<<c.difference.upper;
+			verdicts<<", \"u\": "<<c.test.u<<", \"pValue\": "<<c.test.pValue;
+			verdicts<<", \"baselineCount\": "<<c.baselineCount<<", \"candidateCount\": "<<c.candidateCount<<"}";
+		}
+		verdicts<<"]";
+
+		std::string header;
+		appendHeader(header, "comparison", verdicts.str());
+		writeDataSetEnd(out, timeUnits.c_str(), "", header, fields.str());
+		out.flags(f);
+	}
+
+//====================================================================
+
+}
+
+#endif
@@ -0,0 +1,530 @@
+/*********************************************************************
+* Dataset files: memory-mapped reading, binary format and writing.   *
+*                                                                    *
+* Dataset files are read through a read-only memory mapping, in the  *
+* text format written by TimeProfiler or in a compact binary format  *
+* whose columns can be used in place. Many files can be read in      *
+* parallel, and a DataSet can be written back in either format.      *
+* Dataset streams (".tps") are read as datasets of one series.       *
+*                                                                    *
+* Version: 1.1                                                       *
+* Date:    16-10-2026                                                *
+* Author:  Dan Machado                                               *
+**********************************************************************/
+#ifndef TIME_PROFILER_DATASET_FILE_H
+#define TIME_PROFILER_DATASET_FILE_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <exception>
+#include <iomanip>
+#include <mutex>
+#include <thread>
+
+#ifdef __unix__
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+#endif
+
+#include "time_profiler.h"
+#include "dataset_reader.h"
+#include "dataset_stream.h"
+
+//====================================================================
+
+namespace tprofiler
+{
+
+/*
+ * Read-only view of a whole file, memory-mapped where supported and
+ * read into memory otherwise.
+ *
+ * */
+class MappedFile
+{
+	public:
+		/*
+		 * @throws std::runtime_error if the file cannot be opened
+		 * */
+		explicit MappedFile(const std::string& path)
+		{
+			#ifdef __unix__
+			int fd=::open(path.c_str(), O_RDONLY);
+			if(fd<0){
+				throw std::runtime_error("cannot open "+path);
+			}
+
+			struct stat status;
+			if(::fstat(fd, &status)==0 && status.st_size>0){
+				void* address=::mmap(nullptr, status.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+				if(address!=MAP_FAILED){
+					m_data=static_cast<const char*>(address);
+					m_size=static_cast<std::size_t>(status.st_size);
+					m_mapped=true;
+					::madvise(address, m_size, MADV_SEQUENTIAL);
+				}
+			}
+			::close(fd);
+			if(m_mapped){
+				return;
+			}
+			#endif
+
+			std::ifstream input(path, std::ios::binary);
+			if(!input.is_open()){
+				throw std::runtime_error("cannot open "+path);
+			}
+			m_buffer.assign(std::istreambuf_iterator<char>(input), std::istreambuf_iterator<char>());
+			m_data=m_buffer.data();
+			m_size=m_buffer.size();
+		}
+
+		MappedFile(const MappedFile&)=delete;
+		MappedFile& operator=(const MappedFile&)=delete;
+
+		~MappedFile()
+		{
+			#ifdef __unix__
+			if(m_mapped){
+				::munmap(const_cast<char*>(m_data), m_size);
+			}
+			#endif
+		}
+
+		const char* data() const
+		{
+			return m_data;
+		}
+
+		std::size_t size() const
+		{
+			return m_size;
+		}
+
+	private:
+		const char* m_data{nullptr};
+		std::size_t m_size{0};
+		bool m_mapped{false};
+		std::vector<char> m_buffer{};
+};
+
+//====================================================================
+
+/*
+ * Binary dataset format, native byte order, every field aligned to 8
+ * bytes so a mapped file can be used in place:
+ *
+ * "TPDS" u32 version
+ * string timeUnits, workUnits, xTitle, yTitle, header
+ * array<f64> x, strings xLabels
+ * u64 number of series, then for each series
+ *    string name, colour
+ *    array<f64> data, array<f64> work, array<u32> labels, strings labelNames
+ *
+ * string: u64 length, bytes; array: u64 count, values; strings: u64
+ * count, string...
+ *
+ * */
+	inline namespace internal
+	{
+		constexpr char s_binaryMagic[4]={'T', 'P', 'D', 'S'};
+		constexpr std::uint32_t s_binaryVersion=1;
+
+		inline void writePadding(std::ostream& out, std::size_t written)
+		{
+			static const char zeros[8]={0};
+			out.write(zeros, (8-written%8)%8);
+		}
+
+		inline void writeBinaryCount(std::ostream& out, std::uint64_t count)
+		{
+			out.write(reinterpret_cast<const char*>(&count), sizeof(count));
+		}
+
+		inline void writeBinaryString(std::ostream& out, const std::string& text)
+		{
+			writeBinaryCount(out, text.size());
+			out.write(text.data(), text.size());
+			writePadding(out, text.size());
+		}
+
+		template<typename T>
+		void writeBinaryArray(std::ostream& out, const std::vector<T>& values)
+		{
+			writeBinaryCount(out, values.size());
+			out.write(reinterpret_cast<const char*>(values.data()), values.size()*sizeof(T));
+			writePadding(out, values.size()*sizeof(T));
+		}
+
+		inline void writeBinaryStrings(std::ostream& out, const std::vector<std::string>& values)
+		{
+			writeBinaryCount(out, values.size());
+			for(const std::string& value : values){
+				writeBinaryString(out, value);
+			}
+		}
+
+		/*
+		 * Bounds-checked cursor over a binary dataset.
+		 *
+		 * */
+		class BinaryCursor
+		{
+			public:
+				BinaryCursor(const char* data, std::size_t size)
+				: m_data(data)
+				, m_size(size)
+				{
+				}
+
+				std::uint64_t count()
+				{
+					std::uint64_t value;
+					std::memcpy(&value, take(sizeof(value)), sizeof(value));
+					return value;
+				}
+
+				std::string string()
+				{
+					std::uint64_t length=count();
+					const char* text=take(length);
+					skipPadding(length);
+					return std::string(text, length);
+				}
+
+				std::vector<std::string> strings()
+				{
+					std::uint64_t n=count();
+					std::vector<std::string> values;
+					for(std::uint64_t i=0; i<n; i++){
+						values.push_back(string());
+					}
+					return values;
+				}
+
+				/*
+				 * Pointer to count values of type T inside the buffer.
+				 *
+				 * */
+				template<typename T>
+				const T* array(std::uint64_t& n)
+				{
+					n=count();
+					if(n>(m_size-m_position)/sizeof(T)){
+						fail();
+					}
+					const char* values=take(n*sizeof(T));
+					skipPadding(n*sizeof(T));
+					return reinterpret_cast<const T*>(values);
+				}
+
+				const char* take(std::uint64_t bytes)
+				{
+					if(bytes>m_size-m_position){
+						fail();
+					}
+					const char* current=m_data+m_position;
+					m_position+=bytes;
+					return current;
+				}
+
+			private:
+				const char* m_data;
+				std::size_t m_size;
+				std::size_t m_position{0};
+
+				void skipPadding(std::uint64_t written)
+				{
+					take((8-written%8)%8);
+				}
+
+				[[noreturn]] void fail() const
+				{
+					throw std::runtime_error("truncated binary dataset");
+				}
+		};
+	}
+
+	inline bool isBinaryDataSet(const char* data, std::size_t size)
+	{
+		return size>=8 && std::memcmp(data, s_binaryMagic, 4)==0;
+	}
+
+	inline void writeBinaryDataSet(std::ostream& out, const DataSet& dataSet)
+	{
+		out.write(s_binaryMagic, 4);
+		out.write(reinterpret_cast<const char*>(&s_binaryVersion), sizeof(s_binaryVersion));
+		writeBinaryString(out, dataSet.timeUnits);
+		writeBinaryString(out, dataSet.workUnits);
+		writeBinaryString(out, dataSet.xTitle);
+		writeBinaryString(out, dataSet.yTitle);
+		writeBinaryString(out, dataSet.header);
+		writeBinaryArray(out, dataSet.x);
+		writeBinaryStrings(out, dataSet.xLabels);
+		writeBinaryCount(out, dataSet.series.size());
+		for(const Series& series : dataSet.series){
+			writeBinaryString(out, series.name);
+			writeBinaryString(out, series.colour);
+			writeBinaryArray(out, series.data);
+			writeBinaryArray(out, series.work);
+			writeBinaryArray(out, series.labels);
+			writeBinaryStrings(out, series.labelNames);
+		}
+	}
+
+	/*
+	 * Report a binary dataset to a handler, the columns of doubles are
+	 * passed in place.
+	 *
+	 * @throws std::runtime_error if the data is not a valid binary dataset
+	 * */
+	inline bool parseBinaryDataSet(const char* data, std::size_t size, DataSetHandler& handler)
+	{
+		BinaryCursor cursor(data, size);
+		const char* magic=cursor.take(8);
+		std::uint32_t version;
+		std::memcpy(&version, magic+4, sizeof(version));
+		if(std::memcmp(magic, s_binaryMagic, 4)!=0 || version!=s_binaryVersion){
+			throw std::runtime_error("not a binary dataset of version "+std::to_string(s_binaryVersion));
+		}
+
+		const char* fields[]={"timeUnits", "workUnits", "xTitle", "yTitle"};
+		for(const char* key : fields){
+			std::string value=cursor.string();
+			if(!value.empty()){
+				handler.field(key, value);
+			}
+		}
+		std::string header=cursor.string();
+		if(!header.empty()){
+			handler.rawField("header", header);
+		}
+
+		std::uint64_t n;
+		const double* x=cursor.array<double>(n);
+		if(n>0){
+			handler.fieldValues("x", x, n);
+		}
+		std::vector<std::string> xLabels=cursor.strings();
+		if(!xLabels.empty()){
+			handler.fieldStrings("xLabels", xLabels);
+		}
+
+		std::uint64_t seriesCount=cursor.count();
+		std::vector<double> converted;
+		for(std::uint64_t s=0; s<seriesCount; s++){
+			handler.beginSeries();
+			handler.seriesString("name", cursor.string());
+			handler.seriesString("color", cursor.string());
+
+			const double* values=cursor.array<double>(n);
+			handler.seriesValues("data", values, n);
+			values=cursor.array<double>(n);
+			if(n>0){
+				handler.seriesValues("work", values, n);
+			}
+
+			const std::uint32_t* labels=cursor.array<std::uint32_t>(n);
+			if(n>0){
+				converted.assign(labels, labels+n);
+				handler.seriesValues("labels", converted.data(), n);
+			}
+			std::vector<std::string> labelNames=cursor.strings();
+			if(!labelNames.empty()){
+				handler.seriesStrings("labelNames", labelNames);
+			}
+			handler.endSeries();
+
+			if(!handler.progress(size)){
+				return false;
+			}
+		}
+		return true;
+	}
+
+//====================================================================
+
+	/*
+	 * Write a DataSet in the text format read by the visualizer.
+	 *
+	 * */
+	inline void writeTextDataSet(std::ostream& out, const DataSet& dataSet)
+	{
+		std::ios_base::fmtflags f(out.flags());
+		out<<std::setprecision(15);
+		writeDataSetBegin(out);
+		for(std::size_t i=0; i<dataSet.series.size(); i++){
+			const Series& series=dataSet.series[i];
+			out<<(i>0 ? ",\n" : "")<<"{\"name\": ";
+			writeJsonString(out, series.name);
+			out<<", \"color\": ";
+			writeJsonString(out, series.colour);
+			out<<", \"data\":";
+			writeJsonArray(out, series.data, series.data.size());
+			if(!series.work.empty()){
+				out<<", \"work\":";
+				writeJsonArray(out, series.work, series.work.size());
+			}
+			if(!series.labels.empty()){
+				out<<", \"labels\":";
+				writeJsonArray(out, series.labels, series.labels.size());
+				out<<", \"labelNames\": [";
+				for(std::size_t j=0; j<series.labelNames.size(); j++){
+					out<<(j>0 ? ", " : "");
+					writeJsonString(out, series.labelNames[j]);
+				}
+				out<<"]";
+			}
+			out<<"}";
+		}
+
+		std::ostringstream fields;
+		fields<<std::setprecision(15);
+		auto key=[&fields](const char* name){
+			fields<<(fields.tellp()>0 ? ", " : "")<<'"'<<name<<"\": ";
+		};
+		if(!dataSet.xTitle.empty()){
+			key("xTitle");
+			writeJsonString(fields, dataSet.xTitle);
+		}
+		if(!dataSet.yTitle.empty()){
+			key("yTitle");
+			writeJsonString(fields, dataSet.yTitle);
+		}
+		if(!dataSet.x.empty()){
+			key("x");
+			writeJsonArray(fields, dataSet.x, dataSet.x.size());
+		}
+		if(!dataSet.xLabels.empty()){
+			key("xLabels");
+			fields<<"[";
+			for(std::size_t j=0; j<dataSet.xLabels.size(); j++){
+				fields<<(j>0 ? ", " : "");
+				writeJsonString(fields, dataSet.xLabels[j]);
+			}
+			fields<<"]";
+		}
+
+		// the header is kept as its JSON text, without the braces
+		std::string header=dataSet.header;
+		if(header.size()>=2 && header.front()=='{' && header.back()=='}'){
+			header=header.substr(1, header.size()-2);
+		}
+		std::string timeUnits=dataSet.timeUnits.empty() ? "μs" : dataSet.timeUnits;
+		writeDataSetEnd(out, timeUnits.c_str(), dataSet.workUnits, header, fields.str());
+		out.flags(f);
+	}
+
+//--------------------------------------------------------------------
+
+	/*
+	 * Parse a text, binary or stream dataset file through a memory
+	 * mapping.
+	 *
+	 * @return false if the handler cancelled the parsing
+	 * @throws std::runtime_error if the file cannot be read or is malformed
+	 * */
+	inline bool parseMappedDataSetFile(const std::string& path, DataSetHandler& handler)
+	{
+		MappedFile file(path);
+		if(isBinaryDataSet(file.data(), file.size())){
+			return parseBinaryDataSet(file.data(), file.size(), handler);
+		}
+		if(isDataSetStream(file.data(), file.size())){
+			return parseDataSetStream(file.data(), file.size(), handler);
+		}
+		BufferSource source(file.data(), file.size());
+		DataSetParser<BufferSource> parser(source, handler);
+		return parser.parse();
+	}
+
+	inline DataSet readDataSetFile(const std::string& path)
+	{
+		DataSet dataSet;
+		DataSetBuilder builder(dataSet);
+		parseMappedDataSetFile(path, builder);
+		return dataSet;
+	}
+
+	/*
+	 * Read many files in parallel, in the order of paths.
+	 *
+	 * @param threads number of threads, 0 for one per core
+	 * @throws std::runtime_error with the path of the first file failing
+	 * */
+	inline std::vector<DataSet> readDataSetFiles(const std::vector<std::string>& paths, unsigned threads=0)
+	{
+		std::vector<DataSet> dataSets(paths.size());
+		if(threads==0){
+			threads=std::max(1u, std::thread::hardware_concurrency());
+		}
+		threads=std::min<unsigned>(threads, std::max<std::size_t>(paths.size(), 1));
+
+		std::atomic<std::size_t> next{0};
+		std::mutex errorMutex;
+		std::string error;
+		std::size_t errorIndex=paths.size();
+		auto worker=[&]{
+			for(std::size_t i=next.fetch_add(1); i<paths.size(); i=next.fetch_add(1)){
+				try{
+					dataSets[i]=readDataSetFile(paths[i]);
+				}
+				catch(const std::exception& e){
+					std::lock_guard<std::mutex> lock(errorMutex);
+					if(i<errorIndex){
+						errorIndex=i;
+						error=paths[i]+": "+e.what();
+					}
+				}
+			}
+		};
+
+		std::vector<std::thread> pool;
+		for(unsigned t=1; t<threads; t++){
+			pool.emplace_back(worker);
+		}
+		worker();
+		for(std::thread& thread : pool){
+			thread.join();
+		}
+
+		if(errorIndex<paths.size()){
+			throw std::runtime_error(error);
+		}
+		return dataSets;
+	}
+
+	/*
+	 * Write a DataSet, in the binary format if the path ends in ".tpd".
+	 *
+	 * @throws std::runtime_error if the file cannot be written
+	 * */
+	inline void writeDataSetFile(const std::string& path, const DataSet& dataSet)
+	{
+		bool binary=path.size()>4 && path.compare(path.size()-4, 4, ".tpd")==0;
+		std::ofstream out(path, binary ? std::ios::binary : std::ios::out);
+		if(!out.is_open()){
+			throw std::runtime_error("cannot write "+path);
+		}
+
+		if(binary){
+			writeBinaryDataSet(out, dataSet);
+		}
+		else{
+			writeTextDataSet(out, dataSet);
+		}
+
+		out.flush();
+		if(!out){
+			throw std::runtime_error("error writing "+path);
+		}
+	}
+
+//====================================================================
+
+}
+
+#endif
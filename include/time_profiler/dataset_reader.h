@@ -0,0 +1,1030 @@
+/*********************************************************************
+* Reader for the dataset files written by TimeProfiler.              *
+*                                                                    *
+* DataSetParser walks a {"dataSet": [...], "timeUnits": ...} file    *
+* and reports series and columns of values to a DataSetHandler in    *
+* blocks, so large files can be processed without holding them in    *
+* memory. loadDataSet() builds the whole DataSet for small files.    *
+* Structure is scanned 16 bytes at a time with SSE2 where available  *
+* and numbers are parsed with std::from_chars (exact, no locale).    *
+*                                                                    *
+* Version: 1.1                                                       *
+* Date:    16-10-2026                                                *
+* Author:  Dan Machado                                               *
+**********************************************************************/
+#ifndef TIME_PROFILER_DATASET_READER_H
+#define TIME_PROFILER_DATASET_READER_H
+
+#include <algorithm>
+#include <charconv>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#ifdef __SSE2__
+	#include <emmintrin.h>
+#endif
+
+//====================================================================
+
+namespace tprofiler
+{
+	struct Series
+	{
+		std::string name{};
+		std::string colour{};
+		std::vector<double> data{};
+		std::vector<double> work{};
+		std::vector<std::uint32_t> labels{};
+		std::vector<std::string> labelNames{};
+	};
+
+	struct DataSet
+	{
+		std::vector<Series> series{};
+		std::string timeUnits{};
+		std::string workUnits{};
+		std::string xTitle{};
+		std::string yTitle{};
+		std::vector<double> x{};
+		std::vector<std::string> xLabels{};
+		std::string header{};     // raw JSON of the header object
+	};
+
+//====================================================================
+
+/*
+ * Receives the content of a dataset file as it is parsed. Numeric
+ * columns arrive in blocks, a column can be split over several calls.
+ *
+ * */
+class DataSetHandler
+{
+	public:
+		virtual ~DataSetHandler()=default;
+
+		virtual void beginSeries()
+		{}
+
+		virtual void endSeries()
+		{}
+
+		// "name", "color"...
+		virtual void seriesString([[maybe_unused]] const std::string& key, [[maybe_unused]] const std::string& value)
+		{}
+
+		// "data", "work", "labels"...
+		virtual void seriesValues([[maybe_unused]] const std::string& key, [[maybe_unused]] const double* values, [[maybe_unused]] std::size_t count)
+		{}
+
+		// "labelNames"
+		virtual void seriesStrings([[maybe_unused]] const std::string& key, [[maybe_unused]] const std::vector<std::string>& values)
+		{}
+
+		// "timeUnits", "workUnits", "xTitle"...
+		virtual void field([[maybe_unused]] const std::string& key, [[maybe_unused]] const std::string& value)
+		{}
+
+		// "x"
+		virtual void fieldValues([[maybe_unused]] const std::string& key, [[maybe_unused]] const double* values, [[maybe_unused]] std::size_t count)
+		{}
+
+		// "xLabels"
+		virtual void fieldStrings([[maybe_unused]] const std::string& key, [[maybe_unused]] const std::vector<std::string>& values)
+		{}
+
+		// "header" and any other object, as JSON text
+		virtual void rawField([[maybe_unused]] const std::string& key, [[maybe_unused]] const std::string& json)
+		{}
+
+		/*
+		 * Called with the number of bytes consumed so far.
+		 *
+		 * @return false to cancel the parsing
+		 * */
+		virtual bool progress([[maybe_unused]] std::size_t bytes)
+		{
+			return true;
+		}
+};
+
+//====================================================================
+
+	inline namespace internal
+	{
+		inline bool isJsonSpace(char c)
+		{
+			return c==' ' || c=='\n' || c=='\r' || c=='\t';
+		}
+
+		/*
+		 * First character of [begin, end) which is not white space.
+		 *
+		 * */
+		inline const char* skipJsonSpaces(const char* begin, const char* end)
+		{
+			// most of the time there is a single space or none
+			if(begin==end || !isJsonSpace(*begin) || begin+1==end || !isJsonSpace(begin[1])){
+				return (begin<end && isJsonSpace(*begin)) ? begin+1 : begin;
+			}
+
+			#ifdef __SSE2__
+			while(end-begin>=16){
+				__m128i chunk=_mm_loadu_si128(reinterpret_cast<const __m128i*>(begin));
+				__m128i spaces=_mm_or_si128(
+					_mm_or_si128(_mm_cmpeq_epi8(chunk, _mm_set1_epi8(' ')), _mm_cmpeq_epi8(chunk, _mm_set1_epi8('\n'))),
+					_mm_or_si128(_mm_cmpeq_epi8(chunk, _mm_set1_epi8('\r')), _mm_cmpeq_epi8(chunk, _mm_set1_epi8('\t')))
+				);
+				unsigned mask=~static_cast<unsigned>(_mm_movemask_epi8(spaces))&0xFFFF;
+				if(mask!=0){
+					return begin+__builtin_ctz(mask);
+				}
+				begin+=16;
+			}
+			#endif
+
+			while(begin<end && isJsonSpace(*begin)){
+				begin++;
+			}
+			return begin;
+		}
+
+		/*
+		 * First character of [begin, end) equal to one of C..., or end.
+		 *
+		 * */
+		template<char... C>
+		inline const char* findAny(const char* begin, const char* end)
+		{
+			#ifdef __SSE2__
+			while(end-begin>=16){
+				__m128i chunk=_mm_loadu_si128(reinterpret_cast<const __m128i*>(begin));
+				__m128i found=_mm_setzero_si128();
+				((found=_mm_or_si128(found, _mm_cmpeq_epi8(chunk, _mm_set1_epi8(C)))), ...);
+				unsigned mask=static_cast<unsigned>(_mm_movemask_epi8(found));
+				if(mask!=0){
+					return begin+__builtin_ctz(mask);
+				}
+				begin+=16;
+			}
+			#endif
+
+			while(begin<end && ((*begin!=C) && ...)){
+				begin++;
+			}
+			return begin;
+		}
+
+		/*
+		 * Parse a number at the beginning of [begin, end), any number.
+		 *
+		 * @return the end of the number, begin if there is no valid number
+		 * */
+		inline const char* parseDoubleGeneral(const char* begin, const char* end, double& value)
+		{
+			#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars>=201611L
+			std::from_chars_result result=std::from_chars(begin, end, value);
+			if(result.ec==std::errc()){
+				return result.ptr;
+			}
+			#endif
+
+			// out of range values, or no floating point std::from_chars
+			char text[64];
+			std::size_t length=0;
+			while(begin+length<end && length<sizeof(text)-1){
+				char c=begin[length];
+				if(!((c>='0' && c<='9') || c=='-' || c=='+' || c=='.' || c=='e' || c=='E')){
+					break;
+				}
+				text[length]=c;
+				length++;
+			}
+			text[length]='\0';
+
+			char* parsed=nullptr;
+			value=std::strtod(text, &parsed);
+			return begin+(parsed-text);
+		}
+
+		/*
+		 * Parse a number at the beginning of [begin, end).
+		 *
+		 * Numbers with at most 19 significant digits, a mantissa below
+		 * 2^53 and a decimal exponent within +-22 (almost all the samples
+		 * written by TimeProfiler) are exact doubles multiplied or divided
+		 * by an exact power of ten: a single, correctly rounded, operation
+		 * (Clinger's fast path). Other numbers go to parseDoubleGeneral().
+		 *
+		 * @return the end of the number, begin if there is no valid number
+		 * */
+		inline const char* parseDouble(const char* begin, const char* end, double& value)
+		{
+			static const double powers[]={1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+				1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+			const char* p=begin;
+			bool negative=p<end && *p=='-';
+			if(negative){
+				p++;
+			}
+
+			std::uint64_t mantissa=0;
+			int digits=0;
+			const char* integer=p;
+			while(p<end && static_cast<unsigned char>(*p-'0')<10){
+				mantissa=mantissa*10+(*p-'0');
+				p++;
+			}
+			digits=static_cast<int>(p-integer);
+			if(digits==0){
+				return parseDoubleGeneral(begin, end, value);
+			}
+
+			int exponent=0;
+			if(p<end && *p=='.'){
+				const char* fraction=++p;
+				while(p<end && static_cast<unsigned char>(*p-'0')<10){
+					mantissa=mantissa*10+(*p-'0');
+					p++;
+				}
+				if(p==fraction){
+					return parseDoubleGeneral(begin, end, value);
+				}
+				exponent=-static_cast<int>(p-fraction);
+				digits+=static_cast<int>(p-fraction);
+			}
+
+			if(p<end && (*p=='e' || *p=='E')){
+				p++;
+				bool negativeExponent=p<end && *p=='-';
+				if(p<end && (*p=='-' || *p=='+')){
+					p++;
+				}
+				const char* exponentDigits=p;
+				int e=0;
+				while(p<end && static_cast<unsigned char>(*p-'0')<10){
+					e=std::min(e*10+(*p-'0'), 100000);
+					p++;
+				}
+				if(p==exponentDigits){
+					return parseDoubleGeneral(begin, end, value);
+				}
+				exponent+=negativeExponent ? -e : e;
+			}
+
+			if(digits>19 || mantissa>(std::uint64_t(1)<<53) || exponent< -22 || exponent>22){
+				return parseDoubleGeneral(begin, end, value);
+			}
+
+			double result=static_cast<double>(mantissa);
+			result=exponent<0 ? result/powers[-exponent] : result*powers[exponent];
+			value=negative ? -result : result;
+			return p;
+		}
+	}
+
+//====================================================================
+
+/*
+ * Characters from a buffer already in memory.
+ *
+ * */
+class BufferSource
+{
+	public:
+		BufferSource(const char* data, std::size_t size)
+		: m_current(data)
+		, m_begin(data)
+		, m_end(data+size)
+		{
+		}
+
+		int peek() const
+		{
+			return m_current<m_end ? static_cast<unsigned char>(*m_current) : -1;
+		}
+
+		void advance()
+		{
+			m_current++;
+		}
+
+		/*
+		 * Contiguous characters from the current position, at least
+		 * minimum of them unless the input ends before.
+		 *
+		 * */
+		const char* window([[maybe_unused]] std::size_t minimum, std::size_t& available) const
+		{
+			available=m_end-m_current;
+			return m_current;
+		}
+
+		void skip(std::size_t count)
+		{
+			m_current+=count;
+		}
+
+		std::size_t position() const
+		{
+			return m_current-m_begin;
+		}
+
+	private:
+		const char* m_current;
+		const char* m_begin;
+		const char* m_end;
+};
+
+//--------------------------------------------------------------------
+
+/*
+ * Characters read from a stream in chunks, the file is never held in
+ * memory as a whole.
+ *
+ * */
+class StreamSource
+{
+	public:
+		explicit StreamSource(std::istream& input, std::size_t chunkSize=1<<20)
+		: m_input(input)
+		, m_buffer(std::max<std::size_t>(chunkSize, 4096))
+		{
+			fill(1);
+		}
+
+		int peek()
+		{
+			if(m_current==m_size && !fill(1)){
+				return -1;
+			}
+			return static_cast<unsigned char>(m_buffer[m_current]);
+		}
+
+		void advance()
+		{
+			m_current++;
+		}
+
+		const char* window(std::size_t minimum, std::size_t& available)
+		{
+			if(m_size-m_current<minimum){
+				fill(minimum);
+			}
+			available=m_size-m_current;
+			return m_buffer.data()+m_current;
+		}
+
+		void skip(std::size_t count)
+		{
+			m_current+=count;
+		}
+
+		std::size_t position() const
+		{
+			return m_consumed+m_current;
+		}
+
+	private:
+		std::istream& m_input;
+		std::vector<char> m_buffer;
+		std::size_t m_current{0};
+		std::size_t m_size{0};
+		std::size_t m_consumed{0};
+		bool m_end{false};
+
+		/*
+		 * Move the unread characters to the front of the buffer and read
+		 * until at least minimum of them (at most a full buffer) are
+		 * available.
+		 *
+		 * */
+		bool fill(std::size_t minimum)
+		{
+			if(m_current>0){
+				std::memmove(m_buffer.data(), m_buffer.data()+m_current, m_size-m_current);
+				m_consumed+=m_current;
+				m_size-=m_current;
+				m_current=0;
+			}
+
+			minimum=std::min(minimum, m_buffer.size());
+			while(!m_end && m_size<minimum){
+				m_input.read(m_buffer.data()+m_size, m_buffer.size()-m_size);
+				std::size_t count=static_cast<std::size_t>(m_input.gcount());
+				m_size+=count;
+				m_end=count==0;
+			}
+			return m_size>0;
+		}
+};
+
+//====================================================================
+
+/*
+ * Source gives access to the character at the current position (peek,
+ * advance) and to a window of contiguous characters from the current
+ * position (window, skip): BufferSource or StreamSource.
+ *
+ * */
+template<typename Source>
+class DataSetParser
+{
+	public:
+		DataSetParser(Source& source, DataSetHandler& handler)
+		: m_source(source)
+		, m_handler(handler)
+		{
+		}
+
+		/*
+		 * Parse the whole document.
+		 *
+		 * @return false if the handler cancelled the parsing
+		 * @throws std::runtime_error on syntax errors
+		 * */
+		bool parse();
+
+	private:
+		static constexpr std::size_t s_blockSize=4096;
+
+		Source& m_source;
+		DataSetHandler& m_handler;
+		std::vector<double> m_block{};
+		std::size_t m_nextProgress{0};
+		bool m_cancelled{false};
+
+		static constexpr std::size_t s_maxNumberLength=64;
+
+		void skipSpaces()
+		{
+			while(true){
+				std::size_t available;
+				const char* begin=m_source.window(1, available);
+				const char* end=skipJsonSpaces(begin, begin+available);
+				m_source.skip(end-begin);
+				if(end<begin+available || available==0){
+					return;
+				}
+			}
+		}
+
+		void expect(char expected)
+		{
+			skipSpaces();
+			if(m_source.peek()!=expected){
+				fail(std::string("expected '")+expected+"'");
+			}
+			m_source.advance();
+		}
+
+		/*
+		 * Consume a ',' and return true, or return false at the closing
+		 * character or once cancelled: a cancel can leave the source
+		 * anywhere, even just before the ']' of an array.
+		 *
+		 * */
+		bool nextElement(char closing)
+		{
+			if(m_cancelled){
+				return false;
+			}
+			skipSpaces();
+			int c=m_source.peek();
+			if(c==','){
+				m_source.advance();
+				return true;
+			}
+			if(c!=closing){
+				fail(std::string("expected ',' or '")+closing+"'");
+			}
+			return false;
+		}
+
+		[[noreturn]] void fail(const std::string& message) const
+		{
+			throw std::runtime_error("dataset syntax error at byte "+std::to_string(m_source.position())+": "+message);
+		}
+
+		std::string parseString();
+		double parseNumber();
+		void parseSeries();
+		void parseField(const std::string& key);
+		void captureValue(std::string& json);
+
+		/*
+		 * Parse an array, numbers are delivered in blocks to onValues
+		 * and strings all at once to onStrings.
+		 *
+		 * */
+		template<typename V, typename S>
+		void parseArray(V onValues, S onStrings);
+
+		template<typename V>
+		std::size_t parseNumbers(V& onValues);
+
+		template<typename V>
+		void pushValue(double value, V& onValues)
+		{
+			m_block.push_back(value);
+			if(m_block.size()==s_blockSize){
+				onValues(m_block.data(), m_block.size());
+				m_block.clear();
+			}
+		}
+
+		void reportProgress()
+		{
+			if(m_source.position()>=m_nextProgress){
+				m_nextProgress=m_source.position()+(1<<22);
+				if(!m_handler.progress(m_source.position())){
+					m_cancelled=true;
+				}
+			}
+		}
+};
+
+//--------------------------------------------------------------------
+
+template<typename Source>
+bool DataSetParser<Source>::parse()
+{
+	m_block.reserve(s_blockSize);
+	expect('{');
+	skipSpaces();
+	if(m_source.peek()=='}'){
+		m_source.advance();
+		return true;
+	}
+
+	do{
+		skipSpaces();
+		std::string key=parseString();
+		expect(':');
+		if(key=="dataSet"){
+			expect('[');
+			skipSpaces();
+			if(m_source.peek()==']'){
+				m_source.advance();
+				continue;
+			}
+			do{
+				parseSeries();
+				if(m_cancelled){
+					return false;
+				}
+			}while(nextElement(']'));
+			m_source.advance();
+		}
+		else{
+			parseField(key);
+		}
+	}while(nextElement('}'));
+	m_source.advance();
+	return !m_cancelled;
+}
+
+//--------------------------------------------------------------------
+
+template<typename Source>
+void DataSetParser<Source>::parseSeries()
+{
+	expect('{');
+	m_handler.beginSeries();
+	skipSpaces();
+	if(m_source.peek()=='}'){
+		m_source.advance();
+		m_handler.endSeries();
+		return;
+	}
+
+	do{
+		skipSpaces();
+		std::string key=parseString();
+		expect(':');
+		skipSpaces();
+		int c=m_source.peek();
+		if(c=='"'){
+			m_handler.seriesString(key, parseString());
+		}
+		else if(c=='['){
+			parseArray(
+				[this, &key](const double* values, std::size_t count){
+					m_handler.seriesValues(key, values, count);
+					reportProgress();
+				},
+				[this, &key](const std::vector<std::string>& values){
+					m_handler.seriesStrings(key, values);
+				}
+			);
+		}
+		else{
+			std::string json;
+			captureValue(json);
+		}
+	}while(nextElement('}'));
+
+	if(!m_cancelled){
+		m_source.advance();
+	}
+	m_handler.endSeries();
+}
+
+//--------------------------------------------------------------------
+
+template<typename Source>
+void DataSetParser<Source>::parseField(const std::string& key)
+{
+	skipSpaces();
+	int c=m_source.peek();
+	if(c=='"'){
+		m_handler.field(key, parseString());
+	}
+	else if(c=='['){
+		parseArray(
+			[this, &key](const double* values, std::size_t count){
+				m_handler.fieldValues(key, values, count);
+			},
+			[this, &key](const std::vector<std::string>& values){
+				m_handler.fieldStrings(key, values);
+			}
+		);
+	}
+	else{
+		std::string json;
+		captureValue(json);
+		m_handler.rawField(key, json);
+	}
+}
+
+//--------------------------------------------------------------------
+
+template<typename Source>
+template<typename V, typename S>
+void DataSetParser<Source>::parseArray(V onValues, S onStrings)
+{
+	expect('[');
+	skipSpaces();
+	if(m_source.peek()==']'){
+		m_source.advance();
+		return;
+	}
+
+	std::vector<std::string> strings;
+	m_block.clear();
+	do{
+		skipSpaces();
+		if(m_source.peek()=='"'){
+			strings.push_back(parseString());
+			continue;
+		}
+
+		if(parseNumbers(onValues)==0){
+			pushValue(parseNumber(), onValues);
+		}
+		if(m_cancelled){
+			return;
+		}
+	}while(nextElement(']'));
+	m_source.advance();
+
+	if(!m_block.empty()){
+		onValues(m_block.data(), m_block.size());
+		m_block.clear();
+	}
+	if(!strings.empty()){
+		onStrings(strings);
+	}
+}
+
+//--------------------------------------------------------------------
+
+/*
+ * Parse a run of numbers separated by commas directly in the window of
+ * the source, stopping after the last number fully inside the window.
+ *
+ * @return the number of values parsed, 0 if the slow path is needed
+ * */
+template<typename Source>
+template<typename V>
+std::size_t DataSetParser<Source>::parseNumbers(V& onValues)
+{
+	std::size_t available;
+	const char* begin=m_source.window(1<<16, available);
+	const char* end=begin+available;
+	const char* limit=available>s_maxNumberLength ? end-s_maxNumberLength : begin;
+
+	const char* current=begin;
+	const char* parsed=begin;
+	std::size_t count=0;
+	while(current<limit && !m_cancelled){
+		double value;
+		const char* next=parseDouble(current, end, value);
+		if(next==current){
+			break;
+		}
+		pushValue(value, onValues);
+		parsed=next;
+		count++;
+
+		current=skipJsonSpaces(next, end);
+		if(current==end || *current!=','){
+			break;
+		}
+		current=skipJsonSpaces(current+1, end);
+	}
+
+	m_source.skip(parsed-begin);
+	return count;
+}
+
+//--------------------------------------------------------------------
+
+template<typename Source>
+double DataSetParser<Source>::parseNumber()
+{
+	std::size_t available;
+	const char* begin=m_source.window(s_maxNumberLength, available);
+	if(available>=4 && std::memcmp(begin, "null", 4)==0){
+		m_source.skip(4);
+		return std::numeric_limits<double>::quiet_NaN();
+	}
+
+	double value;
+	const char* end=parseDouble(begin, begin+std::min(available, s_maxNumberLength), value);
+	if(end==begin){
+		fail("invalid number");
+	}
+	m_source.skip(end-begin);
+	return value;
+}
+
+//--------------------------------------------------------------------
+
+template<typename Source>
+std::string DataSetParser<Source>::parseString()
+{
+	if(m_source.peek()!='"'){
+		fail("expected string");
+	}
+	m_source.advance();
+
+	std::string value;
+	while(true){
+		// copy the run of plain characters at once
+		std::size_t available;
+		const char* begin=m_source.window(1, available);
+		const char* end=findAny<'"', '\\'>(begin, begin+available);
+		value.append(begin, end);
+		m_source.skip(end-begin);
+
+		int c=m_source.peek();
+		if(c<0){
+			fail("unterminated string");
+		}
+		m_source.advance();
+		if(c=='"'){
+			break;
+		}
+		if(c!='\\'){
+			value.push_back(static_cast<char>(c));
+			continue;
+		}
+
+		c=m_source.peek();
+		m_source.advance();
+		switch(c){
+			case 'n': value.push_back('\n'); break;
+			case 't': value.push_back('\t'); break;
+			case 'r': value.push_back('\r'); break;
+			case 'b': value.push_back('\b'); break;
+			case 'f': value.push_back('\f'); break;
+			case 'u':{
+				unsigned code=0;
+				for(int i=0; i<4; i++){
+					int h=m_source.peek();
+					m_source.advance();
+					code<<=4;
+					if(h>='0' && h<='9') code|=h-'0';
+					else if(h>='a' && h<='f') code|=h-'a'+10;
+					else if(h>='A' && h<='F') code|=h-'A'+10;
+					else fail("invalid unicode escape");
+				}
+				if(code<0x80){
+					value.push_back(static_cast<char>(code));
+				}
+				else if(code<0x800){
+					value.push_back(static_cast<char>(0xC0|(code>>6)));
+					value.push_back(static_cast<char>(0x80|(code&0x3F)));
+				}
+				else{
+					value.push_back(static_cast<char>(0xE0|(code>>12)));
+					value.push_back(static_cast<char>(0x80|((code>>6)&0x3F)));
+					value.push_back(static_cast<char>(0x80|(code&0x3F)));
+				}
+				break;
+			}
+			default:
+				if(c<0){
+					fail("unterminated string");
+				}
+				value.push_back(static_cast<char>(c));
+		}
+	}
+	return value;
+}
+
+//--------------------------------------------------------------------
+
+/*
+ * Copy the next JSON value verbatim.
+ *
+ * */
+template<typename Source>
+void DataSetParser<Source>::captureValue(std::string& json)
+{
+	skipSpaces();
+	int depth=0;
+	bool inString=false;
+	while(true){
+		std::size_t available;
+		const char* begin=m_source.window(1, available);
+		const char* end=inString ? findAny<'"', '\\'>(begin, begin+available)
+			: findAny<'"', '{', '}', '[', ']', ','>(begin, begin+available);
+		json.append(begin, end);
+		m_source.skip(end-begin);
+
+		int c=m_source.peek();
+		if(c<0){
+			fail("unexpected end of file");
+		}
+
+		if(inString){
+			json.push_back(static_cast<char>(c));
+			m_source.advance();
+			if(c=='\\'){
+				json.push_back(static_cast<char>(m_source.peek()));
+				m_source.advance();
+			}
+			else if(c=='"'){
+				inString=false;
+			}
+			continue;
+		}
+
+		if(depth==0 && (c==',' || c=='}' || c==']')){
+			break;
+		}
+
+		json.push_back(static_cast<char>(c));
+		m_source.advance();
+		if(c=='"'){
+			inString=true;
+		}
+		else if(c=='{' || c=='['){
+			depth++;
+		}
+		else if(c=='}' || c==']'){
+			depth--;
+			if(depth==0){
+				break;
+			}
+		}
+	}
+
+	while(!json.empty() && (json.back()==' ' || json.back()=='\n' || json.back()=='\r' || json.back()=='\t')){
+		json.pop_back();
+	}
+}
+
+//====================================================================
+
+/*
+ * Handler building a DataSet in memory.
+ *
+ * */
+class DataSetBuilder : public DataSetHandler
+{
+	public:
+		explicit DataSetBuilder(DataSet& dataSet)
+		: m_dataSet(dataSet)
+		{
+		}
+
+		void beginSeries() override
+		{
+			m_dataSet.series.emplace_back();
+		}
+
+		void seriesString(const std::string& key, const std::string& value) override
+		{
+			if(key=="name"){
+				m_dataSet.series.back().name=value;
+			}
+			else if(key=="color"){
+				m_dataSet.series.back().colour=value;
+			}
+		}
+
+		void seriesValues(const std::string& key, const double* values, std::size_t count) override
+		{
+			Series& series=m_dataSet.series.back();
+			if(key=="data"){
+				series.data.insert(series.data.end(), values, values+count);
+			}
+			else if(key=="work"){
+				series.work.insert(series.work.end(), values, values+count);
+			}
+			else if(key=="labels"){
+				for(std::size_t i=0; i<count; i++){
+					series.labels.push_back(static_cast<std::uint32_t>(values[i]));
+				}
+			}
+		}
+
+		void seriesStrings(const std::string& key, const std::vector<std::string>& values) override
+		{
+			if(key=="labelNames"){
+				m_dataSet.series.back().labelNames=values;
+			}
+		}
+
+		void field(const std::string& key, const std::string& value) override
+		{
+			if(key=="timeUnits"){
+				m_dataSet.timeUnits=value;
+			}
+			else if(key=="workUnits"){
+				m_dataSet.workUnits=value;
+			}
+			else if(key=="xTitle"){
+				m_dataSet.xTitle=value;
+			}
+			else if(key=="yTitle"){
+				m_dataSet.yTitle=value;
+			}
+		}
+
+		void fieldValues(const std::string& key, const double* values, std::size_t count) override
+		{
+			if(key=="x"){
+				m_dataSet.x.insert(m_dataSet.x.end(), values, values+count);
+			}
+		}
+
+		void fieldStrings(const std::string& key, const std::vector<std::string>& values) override
+		{
+			if(key=="xLabels"){
+				m_dataSet.xLabels=values;
+			}
+		}
+
+		void rawField(const std::string& key, const std::string& json) override
+		{
+			if(key=="header"){
+				m_dataSet.header=json;
+			}
+		}
+
+	private:
+		DataSet& m_dataSet;
+};
+
+//--------------------------------------------------------------------
+
+/*
+ * Stream a dataset file through a handler.
+ *
+ * @return false if the handler cancelled the parsing
+ * @throws std::runtime_error if the file cannot be opened or is malformed
+ * */
+inline bool parseDataSetFile(const std::string& path, DataSetHandler& handler)
+{
+	std::ifstream input(path, std::ios::binary);
+	if(!input.is_open()){
+		throw std::runtime_error("cannot open "+path);
+	}
+	StreamSource source(input);
+	DataSetParser<StreamSource> parser(source, handler);
+	return parser.parse();
+}
+
+inline DataSet loadDataSet(const std::string& path)
+{
+	DataSet dataSet;
+	DataSetBuilder builder(dataSet);
+	parseDataSetFile(path, builder);
+	return dataSet;
+}
+
+//====================================================================
+
+}
+
+#endif
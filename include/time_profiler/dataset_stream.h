@@ -0,0 +1,278 @@
+/*********************************************************************
+* Dataset streams written by TimeProfiler::streamTo().               *
+*                                                                    *
+* A stream is a text file with one record per line, so it can be    *
+* followed while it grows, parsing only the bytes appended:          *
+*                                                                    *
+*   {"stream": 1, "dataSet": [{"name": ..., "color": ...}], ...}     *
+*   #1 "GET"           label 1 is named GET                          *
+*   12.5               a sample                                      *
+*   12.5 4096 #1       with the work done and its label              *
+*                                                                    *
+* The first line is a dataset without samples: units, header...      *
+* Samples carry the work done when it has "workUnits".               *
+*                                                                    *
+* Version: 1.0                                                       *
+* Date:    16-10-2026                                                *
+* Author:  Dan Machado                                               *
+**********************************************************************/
+#ifndef TIME_PROFILER_DATASET_STREAM_H
+#define TIME_PROFILER_DATASET_STREAM_H
+
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "dataset_reader.h"
+
+//====================================================================
+
+namespace tprofiler
+{
+
+inline bool isDataSetStream(const char* data, std::size_t size)
+{
+	return size>=9 && std::memcmp(data, "{\"stream\"", 9)==0;
+}
+
+//--------------------------------------------------------------------
+
+/*
+ * Incremental reader of a stream: feed it the bytes appended to the
+ * file since the last call, in pieces of any size.
+ *
+ * */
+class DataSetStreamReader
+{
+	public:
+		/*
+		 * Parse the complete lines of data. An incomplete last line is
+		 * kept until the rest of it arrives.
+		 *
+		 * @param samples the new samples are appended to its data, work
+		 *        (if the stream has work units) and labels (0 if unlabelled)
+		 * @return number of samples appended
+		 * @throws std::runtime_error if the header or a sample is malformed
+		 * */
+		std::size_t feed(const char* data, std::size_t size, Series& samples)
+		{
+			std::size_t before=samples.data.size();
+			const char* end=data+size;
+			if(!m_partial.empty()){
+				const char* newline=findAny<'\n'>(data, end);
+				m_partial.append(data, newline);
+				if(newline==end){
+					return 0;
+				}
+				parseLine(m_partial.data(), m_partial.data()+m_partial.size(), samples);
+				m_partial.clear();
+				data=newline+1;
+			}
+
+			while(data<end){
+				const char* newline=findAny<'\n'>(data, end);
+				if(newline==end){
+					m_partial.assign(data, end);
+					break;
+				}
+				parseLine(data, newline, samples);
+				data=newline+1;
+			}
+			return samples.data.size()-before;
+		}
+
+		/*
+		 * The header has been read.
+		 *
+		 * */
+		bool ready() const
+		{
+			return m_ready;
+		}
+
+		/*
+		 * The stream without its samples: a single series with its name,
+		 * colour and label names, the units and the header.
+		 *
+		 * */
+		const DataSet& info() const
+		{
+			return m_info;
+		}
+
+		void reset()
+		{
+			m_info=DataSet{};
+			m_partial.clear();
+			m_ready=false;
+			m_lines=0;
+		}
+
+	private:
+		DataSet m_info{};
+		std::string m_partial{};
+		bool m_ready{false};
+		std::size_t m_lines{0};
+
+		[[noreturn]] void fail(const std::string& message) const
+		{
+			throw std::runtime_error("dataset stream error at line "+std::to_string(m_lines)+": "+message);
+		}
+
+		void parseLine(const char* begin, const char* end, Series& samples)
+		{
+			m_lines++;
+			if(end>begin && end[-1]=='\r'){
+				end--;
+			}
+			begin=skipJsonSpaces(begin, end);
+			if(begin==end){
+				return;
+			}
+
+			if(!m_ready){
+				parseHeader(begin, end);
+			}
+			else if(*begin=='#'){
+				parseLabel(begin+1, end);
+			}
+			else{
+				parseSample(begin, end, samples);
+			}
+		}
+
+		void parseHeader(const char* begin, const char* end)
+		{
+			if(!isDataSetStream(begin, end-begin)){
+				fail("not a dataset stream");
+			}
+			BufferSource source(begin, end-begin);
+			DataSetBuilder builder(m_info);
+			DataSetParser<BufferSource> parser(source, builder);
+			parser.parse();
+			if(m_info.series.size()!=1){
+				fail("a stream holds a single series");
+			}
+			m_ready=true;
+		}
+
+		/*
+		 * "#code "name"", the name as written by writeJsonString().
+		 *
+		 * */
+		void parseLabel(const char* begin, const char* end)
+		{
+			double code;
+			const char* p=parseDouble(begin, end, code);
+			if(p==begin || code<0 || code>UINT16_MAX){
+				fail("invalid label code");
+			}
+			p=skipJsonSpaces(p, end);
+			if(p==end || *p!='"'){
+				fail("expected label name");
+			}
+
+			std::string name;
+			for(p++; p<end && *p!='"'; p++){
+				if(*p=='\\' && p+1<end){
+					p++;
+				}
+				name.push_back(*p);
+			}
+
+			std::vector<std::string>& names=m_info.series[0].labelNames;
+			std::size_t index=static_cast<std::size_t>(code);
+			if(names.size()<=index){
+				names.resize(index+1);
+			}
+			names[index]=name;
+		}
+
+		void parseSample(const char* begin, const char* end, Series& samples)
+		{
+			double value;
+			const char* p=parseDouble(begin, end, value);
+			if(p==begin){
+				fail("invalid sample");
+			}
+			p=skipJsonSpaces(p, end);
+
+			if(!m_info.workUnits.empty()){
+				double work=0;
+				if(p<end && *p!='#'){
+					const char* next=parseDouble(p, end, work);
+					if(next==p){
+						fail("invalid work");
+					}
+					p=skipJsonSpaces(next, end);
+				}
+				samples.work.push_back(work);
+			}
+
+			double label=0;
+			if(p<end && *p=='#'){
+				const char* next=parseDouble(p+1, end, label);
+				if(next==p+1){
+					fail("invalid label");
+				}
+				p=skipJsonSpaces(next, end);
+			}
+			if(p!=end){
+				fail("unexpected characters after the sample");
+			}
+
+			samples.data.push_back(value);
+			samples.labels.push_back(static_cast<std::uint32_t>(label));
+		}
+};
+
+//--------------------------------------------------------------------
+
+/*
+ * Report a whole stream to a handler as a dataset of one series, a
+ * last line without its line break included.
+ *
+ * @throws std::runtime_error if the stream is malformed
+ * */
+inline bool parseDataSetStream(const char* data, std::size_t size, DataSetHandler& handler)
+{
+	DataSetStreamReader reader;
+	Series samples;
+	reader.feed(data, size, samples);
+	reader.feed("\n", 1, samples);
+	if(!reader.ready()){
+		throw std::runtime_error("dataset stream without header");
+	}
+
+	const DataSet& info=reader.info();
+	const Series& series=info.series[0];
+	handler.beginSeries();
+	handler.seriesString("name", series.name);
+	handler.seriesString("color", series.colour);
+	handler.seriesValues("data", samples.data.data(), samples.data.size());
+	if(!samples.work.empty()){
+		handler.seriesValues("work", samples.work.data(), samples.work.size());
+	}
+	if(!series.labelNames.empty()){
+		std::vector<double> labels(samples.labels.begin(), samples.labels.end());
+		handler.seriesValues("labels", labels.data(), labels.size());
+		handler.seriesStrings("labelNames", series.labelNames);
+	}
+	handler.endSeries();
+
+	handler.field("timeUnits", info.timeUnits);
+	if(!info.workUnits.empty()){
+		handler.field("workUnits", info.workUnits);
+	}
+	if(!info.header.empty()){
+		handler.rawField("header", info.header);
+	}
+	return handler.progress(size);
+}
+
+//====================================================================
+
+}
+
+#endif
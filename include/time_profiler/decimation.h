@@ -0,0 +1,244 @@
+/*********************************************************************
+* MinMaxDecimator reduces series to the points worth plotting.       *
+*                                                                    *
+* A range of samples is split in one bucket per horizontal pixel and *
+* every bucket is replaced by its minimum and maximum, in the order  *
+* they occur, so peaks are kept exactly whatever the zoom level.     *
+* Throughput series are plotted as rates: a bucket is the work of    *
+* its samples over their elapsed time.                               *
+*                                                                    *
+* Version: 1.2                                                       *
+* Date:    16-10-2026                                                *
+* Author:  Dan Machado                                               *
+**********************************************************************/
+#ifndef TIME_PROFILER_DECIMATION_H
+#define TIME_PROFILER_DECIMATION_H
+
+#include <algorithm>
+#include <vector>
+
+#include "dataset_reader.h"
+#include "lod_pyramid.h"
+
+//====================================================================
+
+namespace tprofiler
+{
+
+/*
+ * Buckets are the same for every series of a view so their points
+ * line up. When the range has no more than two samples per pixel the
+ * samples are kept as they are, one bucket each.
+ *
+ * */
+class MinMaxDecimator
+{
+	public:
+		/*
+		 * @param first first sample of the range
+		 * @param last sample after the last one of the range
+		 * @param pixels width of the plot
+		 * */
+		MinMaxDecimator(std::size_t first, std::size_t last, std::size_t pixels)
+		: m_first(std::min(first, last))
+		, m_last(last)
+		, m_buckets(std::max<std::size_t>(pixels, 1))
+		, m_reduced(true)
+		{
+			if(m_last-m_first<=2*m_buckets){
+				m_buckets=m_last-m_first;
+				m_reduced=false;
+			}
+		}
+
+		std::size_t first() const
+		{
+			return m_first;
+		}
+
+		std::size_t last() const
+		{
+			return m_last;
+		}
+
+		std::size_t buckets() const
+		{
+			return m_buckets;
+		}
+
+		/*
+		 * @return 2 if buckets are reduced to their minimum and maximum,
+		 * 1 if samples are kept
+		 * */
+		std::size_t pointsPerBucket() const
+		{
+			return m_reduced ? 2 : 1;
+		}
+
+		/*
+		 * First sample of a bucket, bucketStart(buckets()) is last().
+		 *
+		 * */
+		std::size_t bucketStart(std::size_t bucket) const
+		{
+			if(!m_reduced){
+				return m_first+bucket;
+			}
+			return m_first+static_cast<std::size_t>(static_cast<double>(m_last-m_first)*bucket/m_buckets);
+		}
+
+		/*
+		 * Points of one series, pointsPerBucket() for every bucket holding
+		 * samples of the series: fewer if the series ends before last().
+		 *
+		 * */
+		void decimate(const double* values, std::size_t size, std::vector<double>& points) const
+		{
+			points.clear();
+			std::size_t end=std::min(size, m_last);
+			if(end<=m_first){
+				return;
+			}
+
+			if(!m_reduced){
+				points.assign(values+m_first, values+end);
+				return;
+			}
+
+			points.reserve(2*m_buckets);
+			for(std::size_t bucket=0; bucket<m_buckets; bucket++){
+				std::size_t from=bucketStart(bucket);
+				std::size_t to=std::min(bucketStart(bucket+1), end);
+				if(from>=to){
+					break;
+				}
+
+				std::size_t low=from, high=from;
+				for(std::size_t i=from+1; i<to; i++){
+					if(values[i]<values[low]){
+						low=i;
+					}
+					else if(values[i]>values[high]){
+						high=i;
+					}
+				}
+				points.push_back(values[std::min(low, high)]);
+				points.push_back(values[std::max(low, high)]);
+			}
+		}
+
+		/*
+		 * Same points as decimate() read from the pyramid of the series,
+		 * in time proportional to the number of buckets.
+		 *
+		 * */
+		void decimate(const double* values, const LodPyramid& pyramid, std::vector<double>& points) const
+		{
+			points.clear();
+			std::size_t end=std::min(pyramid.size(), m_last);
+			if(end<=m_first){
+				return;
+			}
+
+			if(!m_reduced){
+				points.assign(values+m_first, values+end);
+				return;
+			}
+
+			points.reserve(2*m_buckets);
+			for(std::size_t bucket=0; bucket<m_buckets; bucket++){
+				std::size_t from=bucketStart(bucket);
+				std::size_t to=std::min(bucketStart(bucket+1), end);
+				if(from>=to){
+					break;
+				}
+
+				RangeSummary summary=pyramid.summary(values, from, to);
+				points.push_back(summary.minFirst ? summary.min : summary.max);
+				points.push_back(summary.minFirst ? summary.max : summary.min);
+			}
+		}
+
+		/*
+		 * Rates of a throughput series: work over elapsed time of every
+		 * sample, or of every bucket once reduced, sum(work)/sum(elapsed)
+		 * given twice so the buckets line up with those of decimate().
+		 *
+		 * @param pyramid weighted pyramid of the series, or nullptr
+		 * */
+		void decimateRates(const double* elapsed, const double* work, std::size_t size, const LodPyramid* pyramid, std::vector<double>& points) const
+		{
+			points.clear();
+			std::size_t end=std::min(size, m_last);
+			if(end<=m_first){
+				return;
+			}
+
+			if(!m_reduced){
+				for(std::size_t i=m_first; i<end; i++){
+					points.push_back(elapsed[i]>0 ? work[i]/elapsed[i] : 0);
+				}
+				return;
+			}
+
+			points.reserve(2*m_buckets);
+			for(std::size_t bucket=0; bucket<m_buckets; bucket++){
+				std::size_t from=bucketStart(bucket);
+				std::size_t to=std::min(bucketStart(bucket+1), end);
+				if(from>=to){
+					break;
+				}
+
+				RangeSummary summary;
+				if(pyramid!=nullptr && pyramid->weighted()){
+					summary=pyramid->summary(elapsed, from, to, work);
+				}
+				else{
+					for(std::size_t i=from; i<to; i++){
+						summary.sum+=elapsed[i];
+						summary.work+=work[i];
+					}
+				}
+				points.push_back(summary.rate());
+				points.push_back(summary.rate());
+			}
+		}
+
+	private:
+		std::size_t m_first;
+		std::size_t m_last;
+		std::size_t m_buckets;
+		bool m_reduced;
+};
+
+//--------------------------------------------------------------------
+
+/*
+ * Decimate the data of every series, series are spread over threads,
+ * one per core by default. The pyramids, if given, must be those of
+ * the series. Series with a work column are turned into rates.
+ *
+ * */
+inline std::vector<std::vector<double>> decimateSeries(const MinMaxDecimator& decimator, const std::vector<Series>& series, const std::vector<LodPyramid>& pyramids={}, unsigned threads=0)
+{
+	std::vector<std::vector<double>> points(series.size());
+	bool indexed=pyramids.size()==series.size();
+	parallelFor(series.size(), threads, [&](std::size_t i){
+		if(hasWork(series[i])){
+			decimator.decimateRates(series[i].data.data(), series[i].work.data(), series[i].data.size(), indexed ? &pyramids[i] : nullptr, points[i]);
+		}
+		else if(indexed){
+			decimator.decimate(series[i].data.data(), pyramids[i], points[i]);
+		}
+		else{
+			decimator.decimate(series[i].data.data(), series[i].data.size(), points[i]);
+		}
+	});
+	return points;
+}
+
+//====================================================================
+
+}
+
+#endif
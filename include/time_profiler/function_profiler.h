@@ -0,0 +1,601 @@
+/*********************************************************************
+* FunctionProfiler times every function of a program compiled with   *
+* -finstrument-functions, without adding profilers by hand.          *
+*                                                                    *
+* The compiler calls __cyg_profile_func_enter/exit around every      *
+* function. The hooks, defined in the translation unit including     *
+* this header after #define ENABLE_FUNCTION_HOOKS, append the        *
+* address of the function and a timestamp to a buffer of the thread: *
+* one writer per buffer, so no locks. Names are only resolved when   *
+* the dataset is made, from the ELF symbol tables of the program and *
+* its libraries, or dladdr, into one series per function.            *
+*                                                                    *
+* Version: 1.0                                                       *
+* Date:    16-10-2026                                                *
+* Author:  Dan Machado                                               *
+**********************************************************************/
+#ifndef TIME_PROFILER_FUNCTION_PROFILER_H
+#define TIME_PROFILER_FUNCTION_PROFILER_H
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <cxxabi.h>
+#include <dlfcn.h>
+#include <elf.h>
+#include <fcntl.h>
+#include <fnmatch.h>
+#include <link.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include "dataset_file.h"
+
+// what the hooks run must not be instrumented itself
+#define TPROFILER_NO_INSTRUMENT __attribute__((no_instrument_function))
+
+//====================================================================
+
+namespace tprofiler
+{
+
+inline namespace internal
+{
+	struct FunctionEvent
+	{
+		const void* function;
+		std::uint64_t stamp; // nanoseconds<<1, low bit set on exit
+	};
+
+	struct FunctionChunk
+	{
+		static constexpr std::uint32_t EVENTS=16384;
+
+		FunctionChunk* next;
+		std::uint32_t size;
+		FunctionEvent events[EVENTS];
+	};
+
+	/*
+	 * Written by its thread only. Chunks are published with release
+	 * stores of next and size, so the events can be read while the
+	 * thread is still recording. Buffers are never freed: threads that
+	 * ended still have their events read.
+	 *
+	 * */
+	struct FunctionThread
+	{
+		FunctionThread* next;
+		FunctionChunk* first;
+		FunctionChunk* last;
+		std::uint64_t chunks;
+		std::uint64_t dropped;
+		int tid;
+	};
+
+	/*
+	 * The addresses the filter lists are those recorded if allow is
+	 * set, those skipped otherwise. Sorted, for a binary search. The
+	 * hooks read them through a plain pointer: std::vector members
+	 * could be instrumented.
+	 *
+	 * */
+	struct FunctionFilter
+	{
+		std::vector<std::uintptr_t> storage{};
+		const std::uintptr_t* addresses{nullptr};
+		std::size_t size{0};
+		bool allow{false};
+	};
+
+	struct FunctionHooks
+	{
+		bool enabled;
+		const FunctionFilter* filter;
+		FunctionThread* threads;
+		std::uint64_t maxChunks; // per thread
+	};
+
+	inline FunctionHooks functionHooks{false, nullptr, nullptr, 256};
+	inline thread_local FunctionThread* currentFunctionThread=nullptr;
+
+	inline TPROFILER_NO_INSTRUMENT FunctionChunk* newFunctionChunk()
+	{
+		FunctionChunk* chunk=static_cast<FunctionChunk*>(std::malloc(sizeof(FunctionChunk)));
+		if(chunk!=nullptr){
+			chunk->next=nullptr;
+			chunk->size=0;
+		}
+		return chunk;
+	}
+
+	inline TPROFILER_NO_INSTRUMENT FunctionThread* registerFunctionThread()
+	{
+		FunctionThread* thread=static_cast<FunctionThread*>(std::malloc(sizeof(FunctionThread)));
+		FunctionChunk* chunk=newFunctionChunk();
+		if(thread==nullptr || chunk==nullptr){
+			std::free(thread);
+			std::free(chunk);
+			return nullptr;
+		}
+		thread->first=chunk;
+		thread->last=chunk;
+		thread->chunks=1;
+		thread->dropped=0;
+		thread->tid=static_cast<int>(::syscall(SYS_gettid));
+		thread->next=__atomic_load_n(&functionHooks.threads, __ATOMIC_RELAXED);
+		while(!__atomic_compare_exchange_n(&functionHooks.threads, &thread->next, thread, true, __ATOMIC_RELEASE, __ATOMIC_RELAXED)){
+		}
+		currentFunctionThread=thread;
+		return thread;
+	}
+
+	inline TPROFILER_NO_INSTRUMENT bool filteredFunction(const FunctionFilter* filter, const void* function)
+	{
+		std::uintptr_t address=reinterpret_cast<std::uintptr_t>(function);
+		const std::uintptr_t* low=filter->addresses;
+		std::size_t count=filter->size;
+		while(count>0){
+			std::size_t half=count/2;
+			if(low[half]<address){
+				low+=half+1;
+				count-=half+1;
+			}
+			else{
+				count=half;
+			}
+		}
+		bool listed=low!=filter->addresses+filter->size && *low==address;
+		return listed!=filter->allow;
+	}
+
+	inline TPROFILER_NO_INSTRUMENT std::uint64_t monotonicNanoseconds()
+	{
+		timespec now;
+		::clock_gettime(CLOCK_MONOTONIC, &now);
+		return static_cast<std::uint64_t>(now.tv_sec)*1000000000ull+static_cast<std::uint64_t>(now.tv_nsec);
+	}
+
+	/*
+	 * Called from the hooks, on every function entry and exit: only
+	 * atomic builtins and C functions, nothing that could be
+	 * instrumented and call the hooks again.
+	 *
+	 * */
+	inline TPROFILER_NO_INSTRUMENT void recordFunctionEvent(const void* function, std::uint64_t exit)
+	{
+		if(!__atomic_load_n(&functionHooks.enabled, __ATOMIC_ACQUIRE)){
+			return;
+		}
+		const FunctionFilter* filter=__atomic_load_n(&functionHooks.filter, __ATOMIC_ACQUIRE);
+		if(filter!=nullptr && filteredFunction(filter, function)){
+			return;
+		}
+
+		FunctionThread* thread=currentFunctionThread;
+		if(thread==nullptr && (thread=registerFunctionThread())==nullptr){
+			return;
+		}
+		FunctionChunk* chunk=thread->last;
+		std::uint32_t size=chunk->size;
+		if(size==FunctionChunk::EVENTS){
+			FunctionChunk* next=nullptr;
+			if(thread->chunks>=__atomic_load_n(&functionHooks.maxChunks, __ATOMIC_RELAXED) || (next=newFunctionChunk())==nullptr){
+				__atomic_store_n(&thread->dropped, thread->dropped+1, __ATOMIC_RELAXED);
+				return;
+			}
+			__atomic_store_n(&chunk->next, next, __ATOMIC_RELEASE);
+			thread->last=next;
+			thread->chunks++;
+			chunk=next;
+			size=0;
+		}
+
+		chunk->events[size]=FunctionEvent{function, (monotonicNanoseconds()<<1)|exit};
+		__atomic_store_n(&chunk->size, size+1, __ATOMIC_RELEASE);
+	}
+
+//--------------------------------------------------------------------
+
+	struct FunctionSymbol
+	{
+		std::uintptr_t begin;
+		std::uintptr_t end;
+		std::string name;
+	};
+
+	inline std::string demangle(const char* name)
+	{
+		int status=0;
+		char* demangled=abi::__cxa_demangle(name, nullptr, nullptr, &status);
+		if(status!=0 || demangled==nullptr){
+			return name;
+		}
+		std::string result(demangled);
+		std::free(demangled);
+		return result;
+	}
+
+	/*
+	 * The function symbols of an ELF file, .symtab if it was not
+	 * stripped, .dynsym otherwise, at the addresses they are loaded at.
+	 *
+	 * */
+	inline void readElfSymbols(const std::string& path, std::uintptr_t base, std::vector<FunctionSymbol>& symbols)
+	{
+		int fd=::open(path.c_str(), O_RDONLY|O_CLOEXEC);
+		if(fd<0){
+			return;
+		}
+		struct stat status;
+		void* mapped=MAP_FAILED;
+		if(::fstat(fd, &status)==0 && static_cast<std::size_t>(status.st_size)>sizeof(ElfW(Ehdr))){
+			mapped=::mmap(nullptr, static_cast<std::size_t>(status.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+		}
+		::close(fd);
+		if(mapped==MAP_FAILED){
+			return;
+		}
+
+		const char* data=static_cast<const char*>(mapped);
+		std::size_t size=static_cast<std::size_t>(status.st_size);
+		const ElfW(Ehdr)* elf=reinterpret_cast<const ElfW(Ehdr)*>(data);
+		bool valid=std::memcmp(elf->e_ident, ELFMAG, SELFMAG)==0 && elf->e_shoff!=0
+			&& elf->e_shentsize==sizeof(ElfW(Shdr)) && elf->e_shoff+elf->e_shnum*sizeof(ElfW(Shdr))<=size;
+		if(valid){
+			const ElfW(Shdr)* sections=reinterpret_cast<const ElfW(Shdr)*>(data+elf->e_shoff);
+			const ElfW(Shdr)* table=nullptr;
+			for(std::uint32_t i=0; i<elf->e_shnum; i++){
+				if(sections[i].sh_type==SHT_SYMTAB || (sections[i].sh_type==SHT_DYNSYM && table==nullptr)){
+					table=&sections[i];
+				}
+			}
+			if(table!=nullptr && table->sh_link<elf->e_shnum && table->sh_offset+table->sh_size<=size){
+				const ElfW(Shdr)& strings=sections[table->sh_link];
+				const ElfW(Sym)* entries=reinterpret_cast<const ElfW(Sym)*>(data+table->sh_offset);
+				std::size_t count=table->sh_size/sizeof(ElfW(Sym));
+				for(std::size_t i=0; i<count && strings.sh_offset+strings.sh_size<=size; i++){
+					const ElfW(Sym)& entry=entries[i];
+					if(ELF64_ST_TYPE(entry.st_info)!=STT_FUNC || entry.st_value==0 || entry.st_name>=strings.sh_size){
+						continue;
+					}
+					std::uintptr_t begin=base+entry.st_value;
+					symbols.push_back(FunctionSymbol{begin, begin+std::max<std::uintptr_t>(entry.st_size, 1), demangle(data+strings.sh_offset+entry.st_name)});
+				}
+			}
+		}
+		::munmap(mapped, size);
+	}
+
+	/*
+	 * The function symbols of the program and of the libraries loaded,
+	 * sorted by address, one per address.
+	 *
+	 * */
+	inline std::vector<FunctionSymbol> loadedFunctionSymbols()
+	{
+		std::vector<std::pair<std::string, std::uintptr_t>> objects;
+		::dl_iterate_phdr([](dl_phdr_info* info, std::size_t, void* data){
+			auto* objects=static_cast<std::vector<std::pair<std::string, std::uintptr_t>>*>(data);
+			std::string name=info->dlpi_name!=nullptr ? info->dlpi_name : "";
+			objects->emplace_back(name.empty() ? "/proc/self/exe" : name, static_cast<std::uintptr_t>(info->dlpi_addr));
+			return 0;
+		}, &objects);
+
+		std::vector<FunctionSymbol> symbols;
+		for(const auto& object : objects){
+			readElfSymbols(object.first, object.second, symbols);
+		}
+		std::stable_sort(symbols.begin(), symbols.end(), [](const FunctionSymbol& a, const FunctionSymbol& b){
+			return a.begin<b.begin;
+		});
+		symbols.erase(std::unique(symbols.begin(), symbols.end(), [](const FunctionSymbol& a, const FunctionSymbol& b){
+			return a.begin==b.begin;
+		}), symbols.end());
+		return symbols;
+	}
+
+	inline std::string functionName(const std::vector<FunctionSymbol>& symbols, const void* function)
+	{
+		std::uintptr_t address=reinterpret_cast<std::uintptr_t>(function);
+		auto found=std::upper_bound(symbols.begin(), symbols.end(), address, [](std::uintptr_t a, const FunctionSymbol& symbol){
+			return a<symbol.begin;
+		});
+		if(found!=symbols.begin() && address<(found-1)->end){
+			return (found-1)->name;
+		}
+
+		Dl_info info;
+		if(::dladdr(function, &info)!=0 && info.dli_sname!=nullptr){
+			return demangle(info.dli_sname);
+		}
+		char hex[32];
+		std::snprintf(hex, sizeof(hex), "%p", function);
+		return hex;
+	}
+}
+
+//--------------------------------------------------------------------
+
+enum class FunctionTime
+{
+	Inclusive, // the function and all it calls
+	Self       // the function without the functions it calls
+};
+
+/*
+ * Every function compiled with -finstrument-functions, in one
+ * translation unit:
+ *
+ * #define ENABLE_FUNCTION_HOOKS
+ * #include "time_profiler/function_profiler.h"
+ *
+ * tprofiler::FunctionProfiler functions;
+ * functions.include("parser::*").exclude("*::operator*");
+ * functions.start();
+ * ...
+ * functions.stop();
+ * functions.flush("/tmp/functions.json");
+ *
+ * The hooks are process wide: so is what every FunctionProfiler
+ * records, there is no need for more than one.
+ *
+ * */
+class FunctionProfiler
+{
+	public:
+		/*
+		 * Only the functions matching a pattern are recorded, once one
+		 * is given. Patterns are shell wildcards on demangled names,
+		 * "parser::*" or "*Matrix*", and apply from the next start().
+		 *
+		 * */
+		FunctionProfiler& include(const std::string& pattern)
+		{
+			m_include.push_back(pattern);
+			return *this;
+		}
+
+		/*
+		 * Functions matching a pattern are never recorded, small ones
+		 * called often are worth excluding: each call costs two events.
+		 *
+		 * */
+		FunctionProfiler& exclude(const std::string& pattern)
+		{
+			m_exclude.push_back(pattern);
+			return *this;
+		}
+
+		/*
+		 * @param events per thread, 4M (64MB) by default, beyond which
+		 *        events are dropped
+		 * */
+		void limit(std::size_t events)
+		{
+			std::uint64_t chunks=std::max<std::uint64_t>(1, (events+FunctionChunk::EVENTS-1)/FunctionChunk::EVENTS);
+			__atomic_store_n(&functionHooks.maxChunks, chunks, __ATOMIC_RELAXED);
+		}
+
+		/*
+		 * Build the filter, if there are patterns, from the symbols of
+		 * what is loaded, and start recording. The buffers are shared
+		 * with earlier sessions: events recorded before the last start()
+		 * are kept but left out of dataSet().
+		 *
+		 * */
+		void start()
+		{
+			__atomic_store_n(&functionHooks.enabled, false, __ATOMIC_RELEASE);
+			m_started=monotonicNanoseconds();
+			const FunctionFilter* filter=nullptr;
+			if(!m_include.empty() || !m_exclude.empty()){
+				filter=buildFilter();
+			}
+			__atomic_store_n(&functionHooks.filter, filter, __ATOMIC_RELEASE);
+			__atomic_store_n(&functionHooks.enabled, true, __ATOMIC_RELEASE);
+		}
+
+		void stop()
+		{
+			__atomic_store_n(&functionHooks.enabled, false, __ATOMIC_RELEASE);
+		}
+
+		/*
+		 * Events not recorded because a thread reached the limit.
+		 *
+		 * */
+		std::uint64_t dropped() const
+		{
+			std::uint64_t dropped=0;
+			for(FunctionThread* thread=__atomic_load_n(&functionHooks.threads, __ATOMIC_ACQUIRE); thread!=nullptr; thread=thread->next){
+				dropped+=__atomic_load_n(&thread->dropped, __ATOMIC_RELAXED);
+			}
+			return dropped;
+		}
+
+		/*
+		 * One series per function, the time of each of its calls in μs,
+		 * labelled with the thread ID. Series come by total time, the
+		 * most expensive first. Calls still running, or started before
+		 * start(), are left out.
+		 *
+		 * */
+		DataSet dataSet(FunctionTime time=FunctionTime::Inclusive) const
+		{
+			static const char* colours[]={"#e6194b", "#3cb44b", "#4363d8", "#f58231", "#911eb4", "#42d4f4", "#f032e6", "#808000"};
+
+			std::map<const void*, Calls> calls;
+			for(FunctionThread* thread=__atomic_load_n(&functionHooks.threads, __ATOMIC_ACQUIRE); thread!=nullptr; thread=thread->next){
+				replay(*thread, time, m_started, calls);
+			}
+
+			std::vector<const Calls*> order;
+			for(const auto& function : calls){
+				order.push_back(&function.second);
+			}
+			std::stable_sort(order.begin(), order.end(), [](const Calls* a, const Calls* b){
+				return a->total>b->total;
+			});
+
+			std::vector<FunctionSymbol> symbols=loadedFunctionSymbols();
+			DataSet dataSet;
+			dataSet.timeUnits="μs";
+			dataSet.header="{\"functionTime\": \""+std::string(time==FunctionTime::Self ? "self" : "inclusive")
+				+"\", \"droppedFunctionEvents\": "+std::to_string(dropped())+"}";
+			for(const Calls* function : order){
+				Series series;
+				series.name=functionName(symbols, function->function);
+				series.colour=colours[dataSet.series.size()%8];
+				series.data=function->durations;
+				series.labelNames.emplace_back("");
+				for(int tid : function->tids){
+					std::string label="tid "+std::to_string(tid);
+					std::size_t code=std::find(series.labelNames.begin(), series.labelNames.end(), label)-series.labelNames.begin();
+					if(code==series.labelNames.size()){
+						series.labelNames.push_back(label);
+					}
+					series.labels.push_back(static_cast<std::uint32_t>(code));
+				}
+				dataSet.series.push_back(std::move(series));
+			}
+			return dataSet;
+		}
+
+		/*
+		 * Write dataSet(time), in the binary format if the path ends
+		 * in ".tpd".
+		 *
+		 * @throws std::runtime_error if the file cannot be written
+		 * */
+		void flush(const std::string& path, FunctionTime time=FunctionTime::Inclusive) const
+		{
+			writeDataSetFile(path, dataSet(time));
+		}
+
+	private:
+		struct Calls
+		{
+			const void* function{nullptr};
+			std::vector<double> durations{}; // μs
+			std::vector<int> tids{};
+			double total{0};
+		};
+
+		struct Frame
+		{
+			const void* function;
+			std::uint64_t begin;
+			std::uint64_t children;
+		};
+
+		std::vector<std::string> m_include{};
+		std::vector<std::string> m_exclude{};
+		std::vector<const FunctionFilter*> m_filters{}; // kept, the hooks may still read them
+		std::uint64_t m_started{0}; // ns, CLOCK_MONOTONIC
+
+		static bool matches(const std::vector<std::string>& patterns, const std::string& name)
+		{
+			for(const std::string& pattern : patterns){
+				if(::fnmatch(pattern.c_str(), name.c_str(), 0)==0){
+					return true;
+				}
+			}
+			return false;
+		}
+
+		const FunctionFilter* buildFilter()
+		{
+			FunctionFilter* filter=new FunctionFilter();
+			filter->allow=!m_include.empty();
+			for(const FunctionSymbol& symbol : loadedFunctionSymbols()){
+				bool recorded=(m_include.empty() || matches(m_include, symbol.name)) && !matches(m_exclude, symbol.name);
+				if(recorded==filter->allow){
+					filter->storage.push_back(symbol.begin);
+				}
+			}
+			filter->addresses=filter->storage.data();
+			filter->size=filter->storage.size();
+			m_filters.push_back(filter);
+			return filter;
+		}
+
+		/*
+		 * Pair the entries and exits of a thread recorded from started
+		 * on. An exit unwinds the frames above the one it closes, entries
+		 * whose exit is missing, as after a longjmp.
+		 *
+		 * */
+		static void replay(const FunctionThread& thread, FunctionTime time, std::uint64_t started, std::map<const void*, Calls>& calls)
+		{
+			std::vector<Frame> stack;
+			for(const FunctionChunk* chunk=thread.first; chunk!=nullptr; chunk=__atomic_load_n(&chunk->next, __ATOMIC_ACQUIRE)){
+				std::uint32_t size=__atomic_load_n(&chunk->size, __ATOMIC_ACQUIRE);
+				for(std::uint32_t i=0; i<size; i++){
+					const FunctionEvent& event=chunk->events[i];
+					std::uint64_t stamp=event.stamp>>1;
+					if(stamp<started){
+						continue;
+					}
+					if((event.stamp&1)==0){
+						stack.push_back(Frame{event.function, stamp, 0});
+						continue;
+					}
+
+					auto frame=std::find_if(stack.rbegin(), stack.rend(), [&event](const Frame& f){
+						return f.function==event.function;
+					});
+					if(frame==stack.rend()){
+						continue;
+					}
+					stack.erase(frame.base(), stack.end());
+					Frame closed=stack.back();
+					stack.pop_back();
+
+					std::uint64_t inclusive=stamp-closed.begin;
+					if(!stack.empty()){
+						stack.back().children+=inclusive;
+					}
+					std::uint64_t elapsed=time==FunctionTime::Self ? inclusive-std::min(inclusive, closed.children) : inclusive;
+					Calls& function=calls[closed.function];
+					function.function=closed.function;
+					function.durations.push_back(elapsed/1000.0);
+					function.tids.push_back(thread.tid);
+					function.total+=elapsed/1000.0;
+				}
+			}
+		}
+};
+
+//====================================================================
+
+}
+
+#ifdef ENABLE_FUNCTION_HOOKS
+
+extern "C"
+{
+	TPROFILER_NO_INSTRUMENT void __cyg_profile_func_enter(void* function, [[maybe_unused]] void* callSite)
+	{
+		tprofiler::recordFunctionEvent(function, 0);
+	}
+
+	TPROFILER_NO_INSTRUMENT void __cyg_profile_func_exit(void* function, [[maybe_unused]] void* callSite)
+	{
+		tprofiler::recordFunctionEvent(function, 1);
+	}
+}
+
+#endif
+
+#endif
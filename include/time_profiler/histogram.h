@@ -0,0 +1,192 @@
+/*********************************************************************
+* LogHistogram counts samples in logarithmic buckets.                *
+*                                                                    *
+* Quantiles of an arbitrarily long stream of samples are estimated   *
+* in constant memory with a bounded relative error, so datasets      *
+* larger than memory can be summarised while they are being read.    *
+*                                                                    *
+* Version: 1.0                                                       *
+* Date:    16-10-2026                                                *
+* Author:  Dan Machado                                               *
+**********************************************************************/
+#ifndef TIME_PROFILER_HISTOGRAM_H
+#define TIME_PROFILER_HISTOGRAM_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+//====================================================================
+
+namespace tprofiler
+{
+
+/*
+ * Every power of two is split into subBuckets buckets of equal width,
+ * the relative error of a quantile is below 1/(2*subBuckets), 0.4% by
+ * default. Values <= 0 are counted in a bucket of their own.
+ *
+ * */
+class LogHistogram
+{
+	public:
+		explicit LogHistogram(int subBuckets=128)
+		: m_subBuckets(std::max(subBuckets, 1))
+		{
+		}
+
+		void add(double value, std::uint64_t count=1)
+		{
+			if(!(value==value) || count==0){ // NaN
+				return;
+			}
+
+			m_count+=count;
+			m_sum+=value*count;
+			m_min=std::min(m_min, value);
+			m_max=std::max(m_max, value);
+			if(value<=0){
+				m_nonPositive+=count;
+				return;
+			}
+
+			slot(bucketIndex(value))+=count;
+		}
+
+		/*
+		 * Add the samples of another histogram with the same subBuckets.
+		 *
+		 * */
+		void merge(const LogHistogram& other)
+		{
+			if(other.m_count==0){
+				return;
+			}
+
+			if(!other.m_counts.empty()){
+				slot(other.m_offset);
+				slot(other.m_offset+static_cast<int>(other.m_counts.size())-1);
+				for(std::size_t i=0; i<other.m_counts.size(); i++){
+					m_counts[other.m_offset-m_offset+i]+=other.m_counts[i];
+				}
+			}
+			m_count+=other.m_count;
+			m_nonPositive+=other.m_nonPositive;
+			m_sum+=other.m_sum;
+			m_min=std::min(m_min, other.m_min);
+			m_max=std::max(m_max, other.m_max);
+		}
+
+		std::uint64_t count() const
+		{
+			return m_count;
+		}
+
+		double min() const
+		{
+			return m_count>0 ? m_min : 0;
+		}
+
+		double max() const
+		{
+			return m_count>0 ? m_max : 0;
+		}
+
+		double mean() const
+		{
+			return m_count>0 ? m_sum/m_count : 0;
+		}
+
+		/*
+		 * @param p probability in [0, 1]
+		 * */
+		double quantile(double p) const
+		{
+			if(m_count==0){
+				return 0;
+			}
+
+			// same rank as stats::sortedQuantile() without interpolation
+			std::uint64_t rank=static_cast<std::uint64_t>(std::clamp(p, 0.0, 1.0)*(m_count-1)+0.5);
+			if(rank<m_nonPositive){
+				return m_min;
+			}
+
+			std::uint64_t seen=m_nonPositive;
+			for(std::size_t i=0; i<m_counts.size(); i++){
+				seen+=m_counts[i];
+				if(seen>rank){
+					return std::clamp(bucketValue(m_offset+static_cast<int>(i)), m_min, m_max);
+				}
+			}
+			return m_max;
+		}
+
+		void reset()
+		{
+			m_counts.clear();
+			m_offset=0;
+			m_count=0;
+			m_nonPositive=0;
+			m_sum=0;
+			m_min=std::numeric_limits<double>::infinity();
+			m_max=-std::numeric_limits<double>::infinity();
+		}
+
+	private:
+		int m_subBuckets;
+		std::vector<std::uint64_t> m_counts{};
+		int m_offset{0};              // bucket index of m_counts[0]
+		std::uint64_t m_count{0};
+		std::uint64_t m_nonPositive{0};
+		double m_sum{0};
+		double m_min{std::numeric_limits<double>::infinity()};
+		double m_max{-std::numeric_limits<double>::infinity()};
+
+		int bucketIndex(double value) const
+		{
+			int exponent;
+			double mantissa=std::frexp(value, &exponent); // [0.5, 1)
+			int sub=static_cast<int>((mantissa-0.5)*2*m_subBuckets);
+			return exponent*m_subBuckets+std::min(sub, m_subBuckets-1);
+		}
+
+		/*
+		 * Middle of a bucket.
+		 *
+		 * */
+		double bucketValue(int index) const
+		{
+			int exponent=index>=0 ? index/m_subBuckets : -((-index+m_subBuckets-1)/m_subBuckets);
+			int sub=index-exponent*m_subBuckets;
+			return std::ldexp(0.5+(sub+0.5)/(2*m_subBuckets), exponent);
+		}
+
+		/*
+		 * Counter of a bucket, the range of buckets grows as needed.
+		 *
+		 * */
+		std::uint64_t& slot(int index)
+		{
+			if(m_counts.empty()){
+				m_offset=index;
+			}
+			if(index<m_offset){
+				m_counts.insert(m_counts.begin(), m_offset-index, 0);
+				m_offset=index;
+			}
+			std::size_t position=static_cast<std::size_t>(index-m_offset);
+			if(position>=m_counts.size()){
+				m_counts.resize(position+1, 0);
+			}
+			return m_counts[position];
+		}
+};
+
+//====================================================================
+
+}
+
+#endif
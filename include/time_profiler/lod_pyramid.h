@@ -0,0 +1,432 @@
+/*********************************************************************
+* LodPyramid is a level of detail index of a series.                *
+*                                                                    *
+* The minimum, maximum and sum of every block of 16, 32, 64...       *
+* samples (and of their work, for throughput series) are computed    *
+* once, then the summary of any range of samples is answered from    *
+* O(log n) blocks, so zooming into a series of millions of samples   *
+* costs time proportional to the pixels plotted.                     *
+*                                                                    *
+* Version: 1.1                                                       *
+* Date:    16-10-2026                                                *
+* Author:  Dan Machado                                               *
+**********************************************************************/
+#ifndef TIME_PROFILER_LOD_PYRAMID_H
+#define TIME_PROFILER_LOD_PYRAMID_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <limits>
+#include <ostream>
+#include <thread>
+#include <vector>
+
+#include "dataset_reader.h"
+
+//====================================================================
+
+namespace tprofiler
+{
+
+inline namespace internal
+{
+	/*
+	 * Call f(i) for every i in [0, count), spread over threads, one per
+	 * core by default.
+	 *
+	 * */
+	template<typename F>
+	void parallelFor(std::size_t count, unsigned threads, F f)
+	{
+		if(threads==0){
+			threads=std::max(1u, std::thread::hardware_concurrency());
+		}
+		threads=std::min<unsigned>(threads, std::max<std::size_t>(count, 1));
+
+		std::atomic<std::size_t> next{0};
+		auto worker=[&]{
+			for(std::size_t i=next.fetch_add(1); i<count; i=next.fetch_add(1)){
+				f(i);
+			}
+		};
+
+		std::vector<std::thread> pool;
+		for(unsigned t=1; t<threads; t++){
+			pool.emplace_back(worker);
+		}
+		worker();
+		for(std::thread& thread : pool){
+			thread.join();
+		}
+	}
+}
+
+//--------------------------------------------------------------------
+
+/*
+ * Summary of a range of samples. Which of the minimum and maximum
+ * comes first is kept so they can be plotted in order.
+ *
+ * */
+struct RangeSummary
+{
+	double min{std::numeric_limits<double>::infinity()};
+	double max{-std::numeric_limits<double>::infinity()};
+	double sum{0};
+	double work{0}; // sum of the work column, weighted pyramids only
+	std::size_t count{0};
+	bool minFirst{true};
+
+	double mean() const
+	{
+		return count>0 ? sum/count : 0;
+	}
+
+	/*
+	 * Work per unit of time of the whole range when the values are
+	 * elapsed times: a ratio of sums, not a mean of ratios.
+	 *
+	 * */
+	double rate() const
+	{
+		return sum>0 ? work/sum : 0;
+	}
+};
+
+//--------------------------------------------------------------------
+
+/*
+ * Level k holds the blocks of 2^(BASE_SHIFT+k) samples, only whole
+ * blocks are kept: the samples at the ends of a range are read from
+ * the series itself. A block takes 25 bytes (min, max, sum and the
+ * order of min and max), 25 bytes per 16 samples at level 0 and
+ * about 3.1 bytes per sample for all the levels together. A weighted
+ * pyramid also keeps the sum of the work of every block, 8 bytes
+ * more: about 4.1 bytes per sample.
+ *
+ * */
+class LodPyramid
+{
+	public:
+		static constexpr unsigned BASE_SHIFT=4;
+
+		LodPyramid()=default;
+
+		LodPyramid(const double* values, std::size_t size, const double* work=nullptr)
+		{
+			build(values, size, work);
+		}
+
+		/*
+		 * @param work if given, the work column of the series (size
+		 *        values), the pyramid is then weighted
+		 * */
+		void build(const double* values, std::size_t size, const double* work=nullptr)
+		{
+			m_size=size;
+			m_weighted=work!=nullptr;
+			m_levels.clear();
+
+			Level level(size>>BASE_SHIFT, m_weighted);
+			const std::size_t width=std::size_t(1)<<BASE_SHIFT;
+			for(std::size_t b=0; b<level.size(); b++){
+				const double* block=values+b*width;
+				std::size_t low=0, high=0;
+				double sum=block[0];
+				for(std::size_t i=1; i<width; i++){
+					if(block[i]<block[low]){
+						low=i;
+					}
+					else if(block[i]>block[high]){
+						high=i;
+					}
+					sum+=block[i];
+				}
+				level.blocks[b]=Block{block[low], block[high], sum};
+				level.minFirst[b]=low<=high;
+				if(m_weighted){
+					double blockWork=0;
+					for(std::size_t i=0; i<width; i++){
+						blockWork+=work[b*width+i];
+					}
+					level.work[b]=blockWork;
+				}
+			}
+
+			while(level.size()>0){
+				Level upper(level.size()/2, m_weighted);
+				for(std::size_t b=0; b<upper.size(); b++){
+					combine(level, 2*b, upper, b);
+				}
+				m_levels.push_back(std::move(level));
+				level=std::move(upper);
+			}
+		}
+
+		/*
+		 * Samples of the series the pyramid was built from.
+		 *
+		 * */
+		std::size_t size() const
+		{
+			return m_size;
+		}
+
+		bool weighted() const
+		{
+			return m_weighted;
+		}
+
+		/*
+		 * Summary of the samples [first, last).
+		 *
+		 * @param values the series the pyramid was built from
+		 * @param work its work column, to sum the work of a weighted
+		 *        pyramid
+		 * */
+		RangeSummary summary(const double* values, std::size_t first, std::size_t last, const double* work=nullptr) const
+		{
+			Accumulator acc;
+			acc.work=m_weighted ? work : nullptr;
+			last=std::min(last, m_size);
+			if(first>=last){
+				return acc.result;
+			}
+
+			const std::size_t width=std::size_t(1)<<BASE_SHIFT;
+			std::size_t headEnd=std::min((first+width-1)&~(width-1), last);
+			std::size_t tailStart=std::max(last&~(width-1), headEnd);
+			for(std::size_t i=first; i<headEnd; i++){
+				acc.addSample(values[i], i);
+			}
+
+			// blocks between the ends, as in a bottom-up segment tree
+			std::size_t left=headEnd>>BASE_SHIFT;
+			std::size_t right=tailStart>>BASE_SHIFT;
+			for(std::size_t level=0; left<right; level++){
+				if(left&1){
+					acc.addBlock(m_levels[level], left, left<<(BASE_SHIFT+level));
+					left++;
+				}
+				if(right&1){
+					right--;
+					acc.addBlock(m_levels[level], right, right<<(BASE_SHIFT+level));
+				}
+				left>>=1;
+				right>>=1;
+			}
+
+			for(std::size_t i=tailStart; i<last; i++){
+				acc.addSample(values[i], i);
+			}
+			acc.result.count=last-first;
+			acc.result.minFirst=acc.minKey<=acc.maxKey;
+			return acc.result;
+		}
+
+		void write(std::ostream& out) const
+		{
+			std::uint64_t size=m_size;
+			out.write(reinterpret_cast<const char*>(&size), sizeof(size));
+			for(const Level& level : m_levels){
+				out.write(reinterpret_cast<const char*>(level.blocks.data()), level.size()*sizeof(Block));
+				out.write(reinterpret_cast<const char*>(level.minFirst.data()), level.size());
+				out.write(reinterpret_cast<const char*>(level.work.data()), level.work.size()*sizeof(double));
+			}
+		}
+
+		/*
+		 * @return false if the stream is not a pyramid of size samples
+		 * */
+		bool read(std::istream& in, std::size_t size, bool weighted=false)
+		{
+			std::uint64_t stored=0;
+			if(!in.read(reinterpret_cast<char*>(&stored), sizeof(stored)) || stored!=size){
+				return false;
+			}
+
+			m_size=size;
+			m_weighted=weighted;
+			m_levels.clear();
+			for(std::size_t blocks=size>>BASE_SHIFT; blocks>0; blocks/=2){
+				Level level(blocks, weighted);
+				if(!in.read(reinterpret_cast<char*>(level.blocks.data()), blocks*sizeof(Block)) || !in.read(reinterpret_cast<char*>(level.minFirst.data()), blocks)
+					|| !in.read(reinterpret_cast<char*>(level.work.data()), level.work.size()*sizeof(double))){
+					m_levels.clear();
+					return false;
+				}
+				m_levels.push_back(std::move(level));
+			}
+			return true;
+		}
+
+	private:
+		struct Block
+		{
+			double min;
+			double max;
+			double sum;
+		};
+
+		struct Level
+		{
+			std::vector<Block> blocks;
+			std::vector<std::uint8_t> minFirst; // 1 if the minimum comes first
+			std::vector<double> work;           // weighted pyramids only
+
+			Level(std::size_t size, bool weighted)
+			: blocks(size)
+			, minFirst(size)
+			, work(weighted ? size : 0)
+			{
+			}
+
+			std::size_t size() const
+			{
+				return blocks.size();
+			}
+		};
+
+		/*
+		 * Ties go to the earliest sample, as in MinMaxDecimator: the order
+		 * key of a block is twice its first sample, plus one for whichever
+		 * of its minimum and maximum comes second.
+		 *
+		 * */
+		struct Accumulator
+		{
+			RangeSummary result{};
+			std::size_t minKey{std::numeric_limits<std::size_t>::max()};
+			std::size_t maxKey{std::numeric_limits<std::size_t>::max()};
+			const double* work{nullptr};
+
+			void addSample(double value, std::size_t position)
+			{
+				update(value, value, 2*position, 2*position);
+				result.sum+=value;
+				if(work!=nullptr){
+					result.work+=work[position];
+				}
+			}
+
+			void addBlock(const Level& level, std::size_t index, std::size_t start)
+			{
+				const Block& block=level.blocks[index];
+				std::size_t second=level.minFirst[index] ? 1 : 0;
+				update(block.min, block.max, 2*start+1-second, 2*start+second);
+				result.sum+=block.sum;
+				if(work!=nullptr){
+					result.work+=level.work[index];
+				}
+			}
+
+			void update(double min, double max, std::size_t minAt, std::size_t maxAt)
+			{
+				if(min<result.min || (min==result.min && minAt<minKey)){
+					result.min=min;
+					minKey=minAt;
+				}
+				if(max>result.max || (max==result.max && maxAt<maxKey)){
+					result.max=max;
+					maxKey=maxAt;
+				}
+			}
+		};
+
+		std::size_t m_size{0};
+		bool m_weighted{false};
+		std::vector<Level> m_levels{};
+
+		static void combine(const Level& level, std::size_t left, Level& upper, std::size_t index)
+		{
+			const Block& l=level.blocks[left];
+			const Block& r=level.blocks[left+1];
+			bool minLeft=l.min<=r.min;
+			bool maxLeft=l.max>=r.max;
+			if(minLeft==maxLeft){
+				upper.minFirst[index]=level.minFirst[minLeft ? left : left+1];
+			}
+			else{
+				upper.minFirst[index]=minLeft;
+			}
+			upper.blocks[index]=Block{minLeft ? l.min : r.min, maxLeft ? l.max : r.max, l.sum+r.sum};
+			if(!upper.work.empty()){
+				upper.work[index]=level.work[left]+level.work[left+1];
+			}
+		}
+};
+
+//--------------------------------------------------------------------
+
+/*
+ * Series with a work column for every sample get weighted pyramids.
+ *
+ * */
+inline bool hasWork(const Series& series)
+{
+	return !series.work.empty() && series.work.size()==series.data.size();
+}
+
+/*
+ * Pyramid of the data of every series, built in parallel.
+ *
+ * */
+inline std::vector<LodPyramid> buildPyramids(const std::vector<Series>& series, unsigned threads=0)
+{
+	std::vector<LodPyramid> pyramids(series.size());
+	parallelFor(series.size(), threads, [&](std::size_t i){
+		pyramids[i].build(series[i].data.data(), series[i].data.size(), hasWork(series[i]) ? series[i].work.data() : nullptr);
+	});
+	return pyramids;
+}
+
+//--------------------------------------------------------------------
+
+/*
+ * Pyramids can be cached in a file next to the dataset, stamp tells
+ * which version of the dataset they were built from (size and
+ * modification time for instance).
+ *
+ * */
+inline void writePyramids(std::ostream& out, const std::vector<LodPyramid>& pyramids, std::uint64_t stamp)
+{
+	out.write("TPL2", 4);
+	std::uint64_t header[2]={stamp, pyramids.size()};
+	out.write(reinterpret_cast<const char*>(header), sizeof(header));
+	for(const LodPyramid& pyramid : pyramids){
+		pyramid.write(out);
+	}
+}
+
+/*
+ * @return false if the cache is not for this stamp and series
+ * */
+inline bool readPyramids(std::istream& in, const std::vector<Series>& series, std::uint64_t stamp, std::vector<LodPyramid>& pyramids)
+{
+	char magic[4];
+	std::uint64_t header[2];
+	if(!in.read(magic, 4) || std::memcmp(magic, "TPL2", 4)!=0){
+		return false;
+	}
+	if(!in.read(reinterpret_cast<char*>(header), sizeof(header)) || header[0]!=stamp || header[1]!=series.size()){
+		return false;
+	}
+
+	pyramids.assign(series.size(), LodPyramid());
+	for(std::size_t i=0; i<series.size(); i++){
+		if(!pyramids[i].read(in, series[i].data.size(), hasWork(series[i]))){
+			pyramids.clear();
+			return false;
+		}
+	}
+	return true;
+}
+
+//====================================================================
+
+}
+
+#endif
@@ -0,0 +1,180 @@
+/*********************************************************************
+* Histograms of the samples of the profilers, for the metrics        *
+* pipeline of always-on services (see metrics_exporter.h).           *
+*                                                                    *
+* Recording a sample adds to atomic counters, and a scrape reads     *
+* them: neither takes a lock, so a scrape never blocks the threads   *
+* taking samples.                                                    *
+*                                                                    *
+* Version: 1.0                                                       *
+* Date:    16-10-2026                                                *
+* Author:  Dan Machado                                               *
+**********************************************************************/
+#ifndef TIME_PROFILER_METRICS_H
+#define TIME_PROFILER_METRICS_H
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <initializer_list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+//====================================================================
+
+namespace tprofiler
+{
+
+/*
+ * Counts of the samples below each upper bound, in seconds, with their
+ * sum. Counts are cumulative, as exposed, only in snapshots.
+ *
+ * */
+class MetricsHistogram
+{
+	public:
+		struct Snapshot
+		{
+			std::vector<double> bounds{};
+			std::vector<std::uint64_t> cumulative{}; // one more than bounds: +Inf
+			double sum{0};
+		};
+
+		/*
+		 * @param bounds upper bounds of the buckets, in seconds
+		 * */
+		explicit MetricsHistogram(std::vector<double> bounds)
+		: m_bounds(sorted(std::move(bounds)))
+		, m_counts(m_bounds.size()+1)
+		{
+		}
+
+		/*
+		 * 1μs to 100s, 1-2.5-5 per decade.
+		 *
+		 * */
+		static std::vector<double> defaultBounds()
+		{
+			std::vector<double> bounds;
+			for(int exponent=-6; exponent<=2; exponent++){
+				for(double step : {1.0, 2.5, 5.0}){
+					if(exponent<2 || step==1.0){
+						bounds.push_back(step*std::pow(10.0, exponent));
+					}
+				}
+			}
+			return bounds;
+		}
+
+		/*
+		 * Safe to call from several threads.
+		 *
+		 * @param seconds a sample, in seconds
+		 * */
+		void observe(double seconds)
+		{
+			std::size_t bucket=static_cast<std::size_t>(std::lower_bound(m_bounds.begin(), m_bounds.end(), seconds)-m_bounds.begin());
+			m_counts[bucket].fetch_add(1, std::memory_order_relaxed);
+			double sum=m_sum.load(std::memory_order_relaxed);
+			while(!m_sum.compare_exchange_weak(sum, sum+seconds, std::memory_order_relaxed)){
+			}
+		}
+
+		/*
+		 * The count is that of the buckets read, so the snapshot is
+		 * consistent even if samples are recorded while it is taken.
+		 *
+		 * */
+		Snapshot snapshot() const
+		{
+			Snapshot snapshot;
+			snapshot.bounds=m_bounds;
+			snapshot.cumulative.resize(m_counts.size());
+			std::uint64_t total=0;
+			for(std::size_t i=0; i<m_counts.size(); i++){
+				total+=m_counts[i].load(std::memory_order_relaxed);
+				snapshot.cumulative[i]=total;
+			}
+			snapshot.sum=m_sum.load(std::memory_order_relaxed);
+			return snapshot;
+		}
+
+	private:
+		std::vector<double> m_bounds;
+		std::vector<std::atomic<std::uint64_t>> m_counts;
+		std::atomic<double> m_sum{0};
+
+		static std::vector<double> sorted(std::vector<double> bounds)
+		{
+			std::sort(bounds.begin(), bounds.end());
+			bounds.erase(std::unique(bounds.begin(), bounds.end()), bounds.end());
+			return bounds;
+		}
+};
+
+//--------------------------------------------------------------------
+
+/*
+ * The histograms exposed, by profiler name. Profilers of the same name,
+ * of different threads for instance, share their histogram. Histograms
+ * outlive their profilers: what is exposed only ever grows, as metrics
+ * pipelines expect of histograms.
+ *
+ * */
+class MetricsRegistry
+{
+	public:
+		struct Entry
+		{
+			std::string name;
+			std::shared_ptr<MetricsHistogram> histogram;
+		};
+
+		/*
+		 * @param bounds upper bounds of the buckets, in seconds, those of
+		 *        the first profiler of the name are kept
+		 * */
+		std::shared_ptr<MetricsHistogram> add(const std::string& name, const std::vector<double>& bounds)
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			std::shared_ptr<MetricsHistogram>& histogram=m_histograms[name];
+			if(!histogram){
+				histogram=std::make_shared<MetricsHistogram>(bounds.empty() ? MetricsHistogram::defaultBounds() : bounds);
+			}
+			return histogram;
+		}
+
+		/*
+		 * Only registering waits for this, never recording.
+		 *
+		 * */
+		std::vector<Entry> entries() const
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			std::vector<Entry> entries;
+			for(const auto& histogram : m_histograms){
+				entries.push_back(Entry{histogram.first, histogram.second});
+			}
+			return entries;
+		}
+
+	private:
+		mutable std::mutex m_mutex{};
+		std::map<std::string, std::shared_ptr<MetricsHistogram>> m_histograms{};
+};
+
+inline MetricsRegistry& metricsRegistry()
+{
+	static MetricsRegistry registry;
+	return registry;
+}
+
+//====================================================================
+
+}
+
+#endif
@@ -0,0 +1,274 @@
+/*********************************************************************
+* MetricsExporter exposes the histograms of the profilers (see       *
+* metrics.h) in the OpenMetrics text format: served over HTTP on a   *
+* local port for Prometheus to scrape, or written to a file from     *
+* time to time for the node_exporter textfile collector.             *
+*                                                                    *
+* Version: 1.1                                                       *
+* Date:    16-10-2026                                                *
+* Author:  Dan Machado                                               *
+**********************************************************************/
+#ifndef TIME_PROFILER_METRICS_EXPORTER_H
+#define TIME_PROFILER_METRICS_EXPORTER_H
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "metrics.h"
+
+//====================================================================
+
+namespace tprofiler
+{
+
+/*
+ * A profiler named "GET /users" is exposed as the histogram
+ * tprofiler_GET__users_seconds. Names differing only in punctuation map
+ * to the same metric: openMetricsText() tells them apart.
+ *
+ * */
+inline std::string metricName(const std::string& name)
+{
+	std::string metric="tprofiler_";
+	for(char c : name){
+		bool valid=(c>='a' && c<='z') || (c>='A' && c<='Z') || (c>='0' && c<='9') || c=='_';
+		metric+=valid ? c : '_';
+	}
+	return metric+"_seconds";
+}
+
+/*
+ * Backslashes and line breaks escaped, as a HELP line needs them.
+ *
+ * */
+inline std::string metricHelp(const std::string& text)
+{
+	std::string help;
+	for(char c : text){
+		if(c=='\\'){
+			help+="\\\\";
+		}
+		else if(c=='\n'){
+			help+="\\n";
+		}
+		else{
+			help+=c;
+		}
+	}
+	return help;
+}
+
+/*
+ * Every histogram of the registry, ended by "# EOF". Lines the older
+ * Prometheus text format does not know are comments to it, so the
+ * text is valid in both formats. Profilers whose names map to a metric
+ * already taken, by a profiler coming first in name order, get a
+ * number: tprofiler_GET__users_2_seconds.
+ *
+ * */
+inline std::string openMetricsText(const MetricsRegistry& registry=metricsRegistry())
+{
+	std::string text;
+	char number[64];
+	std::set<std::string> families;
+	for(const MetricsRegistry::Entry& entry : registry.entries()){
+		std::string name=metricName(entry.name);
+		for(int n=2; !families.insert(name).second; n++){
+			name=metricName(entry.name+"_"+std::to_string(n));
+		}
+		MetricsHistogram::Snapshot snapshot=entry.histogram->snapshot();
+		text+="# TYPE "+name+" histogram\n";
+		text+="# UNIT "+name+" seconds\n";
+		text+="# HELP "+name+" Samples of the profiler "+metricHelp(entry.name)+".\n";
+		for(std::size_t i=0; i<snapshot.cumulative.size(); i++){
+			if(i<snapshot.bounds.size()){
+				std::snprintf(number, sizeof(number), "%.12g", snapshot.bounds[i]);
+			}
+			else{
+				std::strcpy(number, "+Inf");
+			}
+			text+=name+"_bucket{le=\""+number+"\"} "+std::to_string(snapshot.cumulative[i])+"\n";
+		}
+		std::snprintf(number, sizeof(number), "%.17g", snapshot.sum);
+		text+=name+"_count "+std::to_string(snapshot.cumulative.back())+"\n";
+		text+=name+"_sum "+number+"\n";
+	}
+	text+="# EOF\n";
+	return text;
+}
+
+//--------------------------------------------------------------------
+
+class MetricsExporter
+{
+	public:
+		MetricsExporter()=default;
+		MetricsExporter(const MetricsExporter&)=delete;
+		MetricsExporter& operator=(const MetricsExporter&)=delete;
+
+		~MetricsExporter()
+		{
+			stop();
+		}
+
+		/*
+		 * Serve GET /metrics on a thread of its own.
+		 *
+		 * @param address the interface, local only by default
+		 * @throws std::runtime_error if the port cannot be listened on
+		 * */
+		void serve(unsigned short port, const std::string& address="127.0.0.1")
+		{
+			stop();
+			sockaddr_in socketAddress;
+			std::memset(&socketAddress, 0, sizeof(socketAddress));
+			socketAddress.sin_family=AF_INET;
+			socketAddress.sin_port=htons(port);
+			if(::inet_pton(AF_INET, address.c_str(), &socketAddress.sin_addr)!=1){
+				throw std::runtime_error("invalid address "+address);
+			}
+
+			int fd=::socket(AF_INET, SOCK_STREAM|SOCK_CLOEXEC, 0);
+			if(fd<0){
+				throw std::runtime_error(std::string("socket: ")+std::strerror(errno));
+			}
+			int reuse=1;
+			::setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+			if(::bind(fd, reinterpret_cast<const sockaddr*>(&socketAddress), sizeof(socketAddress))<0 || ::listen(fd, 16)<0){
+				int error=errno;
+				::close(fd);
+				throw std::runtime_error("cannot listen on "+address+":"+std::to_string(port)+": "+std::strerror(error));
+			}
+
+			m_stop.store(false);
+			m_worker=std::thread([this, fd]{
+				while(!m_stop.load()){
+					pollfd descriptor{fd, POLLIN, 0};
+					if(::poll(&descriptor, 1, POLL_MS)>0){
+						int connection=::accept4(fd, nullptr, nullptr, SOCK_CLOEXEC);
+						if(connection>=0){
+							respond(connection);
+							::close(connection);
+						}
+					}
+				}
+				::close(fd);
+			});
+		}
+
+		/*
+		 * Write the metrics to path every period on a thread of its own,
+		 * and once more when stopped. The file is replaced at once, never
+		 * read half written.
+		 *
+		 * */
+		void writeTextfile(const std::string& path, std::chrono::milliseconds period=std::chrono::seconds(15))
+		{
+			stop();
+			m_stop.store(false);
+			m_worker=std::thread([this, path, period]{
+				auto next=std::chrono::steady_clock::now();
+				while(true){
+					if(std::chrono::steady_clock::now()>=next || m_stop.load()){
+						std::string temporary=path+".tmp";
+						{
+							std::ofstream out(temporary, std::ios::trunc);
+							out<<openMetricsText();
+						}
+						std::rename(temporary.c_str(), path.c_str());
+						next=std::chrono::steady_clock::now()+period;
+					}
+					if(m_stop.load()){
+						break;
+					}
+					std::this_thread::sleep_for(std::min(std::chrono::milliseconds(POLL_MS), period));
+				}
+			});
+		}
+
+		void stop()
+		{
+			m_stop.store(true);
+			if(m_worker.joinable()){
+				m_worker.join();
+			}
+		}
+
+	private:
+		// how often the stop flag is checked
+		static constexpr int POLL_MS=100;
+
+		std::thread m_worker{};
+		std::atomic<bool> m_stop{false};
+
+		/*
+		 * Requests are answered one at a time, a client that does not
+		 * send its request within a second is dropped.
+		 *
+		 * */
+		static void respond(int connection)
+		{
+			timeval timeout{1, 0};
+			::setsockopt(connection, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+			::setsockopt(connection, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+
+			std::string request;
+			char buffer[2048];
+			while(request.find("\r\n\r\n")==std::string::npos && request.size()<16*1024){
+				ssize_t count=::recv(connection, buffer, sizeof(buffer), 0);
+				if(count<=0){
+					return;
+				}
+				request.append(buffer, static_cast<std::size_t>(count));
+			}
+
+			std::string status="200 OK";
+			std::string type="text/plain; version=0.0.4; charset=utf-8";
+			std::string body;
+			std::size_t end=request.find(' ', 4);
+			std::string path=request.compare(0, 4, "GET ")==0 && end!=std::string::npos ? request.substr(4, end-4) : "";
+			if(path=="/metrics" || path=="/"){
+				body=openMetricsText();
+				if(request.find("application/openmetrics-text")!=std::string::npos){
+					type="application/openmetrics-text; version=1.0.0; charset=utf-8";
+				}
+			}
+			else{
+				status="404 Not Found";
+				body="Not found, the metrics are at /metrics\n";
+			}
+
+			std::string response="HTTP/1.1 "+status+"\r\nContent-Type: "+type+"\r\nContent-Length: "+std::to_string(body.size())+"\r\nConnection: close\r\n\r\n"+body;
+			const char* p=response.data();
+			std::size_t size=response.size();
+			while(size>0){
+				ssize_t sent=::send(connection, p, size, MSG_NOSIGNAL);
+				if(sent<=0){
+					return;
+				}
+				p+=sent;
+				size-=static_cast<std::size_t>(sent);
+			}
+		}
+};
+
+//====================================================================
+
+}
+
+#endif
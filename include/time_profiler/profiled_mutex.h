@@ -0,0 +1,518 @@
+/*********************************************************************
+* Drop-in replacements for std::mutex and std::shared_mutex that     *
+* tell the time spent waiting for a lock from the time it is held.   *
+*                                                                    *
+* Every mutex belongs to a lock site: a name, or where the mutex is  *
+* declared. Each site has histograms of wait and hold times (see     *
+* metrics.h), exposed with the other metrics and summarized by       *
+* printLockContention().                                             *
+*                                                                    *
+* A lock is first tried: when it is free, no clock is read, so the   *
+* uncontended path stays close to that of the plain mutex. Only the  *
+* waits and the holds of the acquisitions that waited are timed,     *
+* unless uncontended holds are sampled with setHoldSampling().       *
+*                                                                    *
+* Version: 1.0                                                       *
+* Date:    16-10-2026                                                *
+* Author:  Dan Machado                                               *
+**********************************************************************/
+#ifndef TIME_PROFILER_PROFILED_MUTEX_H
+#define TIME_PROFILER_PROFILED_MUTEX_H
+
+#include <atomic>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+
+#include "metrics.h"
+
+//====================================================================
+
+namespace tprofiler
+{
+
+/*
+ * Uncontended acquisitions are counted by every mutex and added to its
+ * site in batches of BATCH, so the counts of a mutex still in use lag
+ * by less than BATCH. Contended ones are added at once.
+ *
+ * */
+struct LockSite
+{
+	static constexpr unsigned BATCH=64;
+
+	std::string name{};
+	std::shared_ptr<MetricsHistogram> wait{};
+	std::shared_ptr<MetricsHistogram> hold{};
+	std::shared_ptr<MetricsHistogram> sharedWait{}; // only of shared mutexes
+	std::shared_ptr<MetricsHistogram> sharedHold{};
+	std::atomic<std::uint64_t> acquisitions{0};
+	std::atomic<std::uint64_t> contended{0};
+	std::atomic<std::uint64_t> sharedAcquisitions{0};
+	std::atomic<std::uint64_t> sharedContended{0};
+
+	/*
+	 * 100ns to 10s, 1-2.5-5 per decade: lock waits are often shorter
+	 * than the samples of profilers.
+	 *
+	 * */
+	static std::vector<double> bounds()
+	{
+		std::vector<double> bounds;
+		for(int exponent=-7; exponent<=1; exponent++){
+			for(double step : {1.0, 2.5, 5.0}){
+				if(exponent<1 || step==1.0){
+					bounds.push_back(step*std::pow(10.0, exponent));
+				}
+			}
+		}
+		return bounds;
+	}
+};
+
+//--------------------------------------------------------------------
+
+/*
+ * The lock sites, by name. Sites are never removed, mutexes of the
+ * same name share theirs.
+ *
+ * */
+class LockSites
+{
+	public:
+		LockSite& site(const std::string& name, bool shared)
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			std::unique_ptr<LockSite>& site=m_sites[name];
+			if(!site){
+				site=std::make_unique<LockSite>();
+				site->name=name;
+				site->wait=metricsRegistry().add(name+" lock wait", LockSite::bounds());
+				site->hold=metricsRegistry().add(name+" lock hold", LockSite::bounds());
+			}
+			if(shared && !site->sharedWait){
+				site->sharedWait=metricsRegistry().add(name+" shared lock wait", LockSite::bounds());
+				site->sharedHold=metricsRegistry().add(name+" shared lock hold", LockSite::bounds());
+			}
+			return *site;
+		}
+
+		std::vector<const LockSite*> sites() const
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			std::vector<const LockSite*> sites;
+			for(const auto& site : m_sites){
+				sites.push_back(site.second.get());
+			}
+			return sites;
+		}
+
+	private:
+		mutable std::mutex m_mutex{};
+		std::map<std::string, std::unique_ptr<LockSite>> m_sites{};
+};
+
+inline LockSites& lockSites()
+{
+	static LockSites sites;
+	return sites;
+}
+
+//--------------------------------------------------------------------
+
+inline namespace internal
+{
+	typedef std::chrono::high_resolution_clock lockClock;
+
+	inline double lockSeconds(lockClock::time_point begin, lockClock::time_point end)
+	{
+		return std::chrono::duration<double>(end-begin).count();
+	}
+
+	inline std::string lockSiteName(const char* file, int line)
+	{
+		std::string path(file);
+		std::size_t slash=path.find_last_of('/');
+		return (slash==std::string::npos ? path : path.substr(slash+1))+":"+std::to_string(line);
+	}
+
+	/*
+	 * Shared locks timed by this thread, to find when one was taken
+	 * as it is released: a shared mutex has many holders at once.
+	 *
+	 * */
+	struct SharedHold
+	{
+		const void* mutex;
+		lockClock::time_point since;
+	};
+
+	struct SharedHolds
+	{
+		static constexpr unsigned CAPACITY=8;
+
+		SharedHold holds[CAPACITY];
+		unsigned count;
+	};
+
+	inline thread_local SharedHolds sharedHolds{};
+
+	/*
+	 * Upper bound of the bucket holding the quantile q, the last bound
+	 * if it is beyond.
+	 *
+	 * */
+	inline double bucketQuantile(const MetricsHistogram::Snapshot& snapshot, double q)
+	{
+		std::uint64_t total=snapshot.cumulative.back();
+		if(total==0 || snapshot.bounds.empty()){
+			return 0;
+		}
+		double rank=q*static_cast<double>(total);
+		for(std::size_t i=0; i<snapshot.bounds.size(); i++){
+			if(static_cast<double>(snapshot.cumulative[i])>=rank){
+				return snapshot.bounds[i];
+			}
+		}
+		return snapshot.bounds.back();
+	}
+}
+
+//====================================================================
+
+/*
+ * Example:
+ *
+ * tprofiler::ProfiledMutex queueMutex("queue");   // or just std::mutex's place
+ * {
+ *    std::lock_guard<tprofiler::ProfiledMutex> lock(queueMutex);
+ *    ...
+ * }
+ * tprofiler::printLockContention();
+ *
+ * Without ENABLE_STOPWATCH it is a plain std::mutex.
+ *
+ * */
+class ProfiledMutex
+{
+	public:
+		/*
+		 * @param site the name of the lock site, where the mutex is
+		 *        declared if not given
+		 * */
+		explicit ProfiledMutex([[maybe_unused]] const char* site=nullptr, [[maybe_unused]] const char* file=__builtin_FILE(), [[maybe_unused]] int line=__builtin_LINE())
+		{
+			#ifdef ENABLE_STOPWATCH
+			m_site=&lockSites().site(site!=nullptr ? site : lockSiteName(file, line), false);
+			#endif
+		}
+
+		ProfiledMutex(const ProfiledMutex&)=delete;
+		ProfiledMutex& operator=(const ProfiledMutex&)=delete;
+
+		~ProfiledMutex()
+		{
+			#ifdef ENABLE_STOPWATCH
+			m_site->acquisitions.fetch_add(m_uncontended, std::memory_order_relaxed);
+			#endif
+		}
+
+		/*
+		 * Also time the hold of one uncontended acquisition in period, 0
+		 * (none) by default: those of contended ones are all timed. The
+		 * hold histogram then counts one sampled hold for period
+		 * uncontended ones, its quantiles lean towards contended holds.
+		 *
+		 * */
+		void setHoldSampling(unsigned period)
+		{
+			m_sampling=period;
+		}
+
+		void lock()
+		{
+			#ifdef ENABLE_STOPWATCH
+			if(m_mutex.try_lock()){
+				acquired();
+				return;
+			}
+			lockClock::time_point begin=lockClock::now();
+			m_mutex.lock();
+			m_since=lockClock::now();
+			m_timed=true;
+			m_site->wait->observe(lockSeconds(begin, m_since));
+			m_site->contended.fetch_add(1, std::memory_order_relaxed);
+			m_site->acquisitions.fetch_add(1, std::memory_order_relaxed);
+			#else
+			m_mutex.lock();
+			#endif
+		}
+
+		bool try_lock()
+		{
+			if(!m_mutex.try_lock()){
+				return false;
+			}
+			#ifdef ENABLE_STOPWATCH
+			acquired();
+			#endif
+			return true;
+		}
+
+		void unlock()
+		{
+			#ifdef ENABLE_STOPWATCH
+			if(m_timed){
+				m_timed=false;
+				m_site->hold->observe(lockSeconds(m_since, lockClock::now()));
+			}
+			#endif
+			m_mutex.unlock();
+		}
+
+		const LockSite* site() const
+		{
+			return m_site;
+		}
+
+	private:
+		std::mutex m_mutex{};
+		LockSite* m_site{nullptr};
+		// the members below are only used by the holder of the lock
+		lockClock::time_point m_since{};
+		unsigned m_uncontended{0};
+		unsigned m_unsampled{0};
+		unsigned m_sampling{0};
+		bool m_timed{false};
+
+		void acquired()
+		{
+			if(++m_uncontended==LockSite::BATCH){
+				m_site->acquisitions.fetch_add(LockSite::BATCH, std::memory_order_relaxed);
+				m_uncontended=0;
+			}
+			if(m_sampling>0 && ++m_unsampled>=m_sampling){
+				m_unsampled=0;
+				m_since=lockClock::now();
+				m_timed=true;
+			}
+		}
+};
+
+//--------------------------------------------------------------------
+
+/*
+ * As ProfiledMutex, for std::shared_mutex. Shared acquisitions have
+ * histograms of their own: "<site> shared lock wait" and "hold".
+ *
+ * */
+class ProfiledSharedMutex
+{
+	public:
+		explicit ProfiledSharedMutex([[maybe_unused]] const char* site=nullptr, [[maybe_unused]] const char* file=__builtin_FILE(), [[maybe_unused]] int line=__builtin_LINE())
+		{
+			#ifdef ENABLE_STOPWATCH
+			m_site=&lockSites().site(site!=nullptr ? site : lockSiteName(file, line), true);
+			#endif
+		}
+
+		ProfiledSharedMutex(const ProfiledSharedMutex&)=delete;
+		ProfiledSharedMutex& operator=(const ProfiledSharedMutex&)=delete;
+
+		~ProfiledSharedMutex()
+		{
+			#ifdef ENABLE_STOPWATCH
+			m_site->acquisitions.fetch_add(m_uncontended, std::memory_order_relaxed);
+			m_site->sharedAcquisitions.fetch_add(m_sharedUncontended.load(std::memory_order_relaxed)%LockSite::BATCH, std::memory_order_relaxed);
+			#endif
+		}
+
+		/*
+		 * As ProfiledMutex::setHoldSampling(), for exclusive and shared
+		 * acquisitions. Set it before the mutex is used.
+		 *
+		 * */
+		void setHoldSampling(unsigned period)
+		{
+			m_sampling=period;
+		}
+
+		void lock()
+		{
+			#ifdef ENABLE_STOPWATCH
+			if(m_mutex.try_lock()){
+				acquired();
+				return;
+			}
+			lockClock::time_point begin=lockClock::now();
+			m_mutex.lock();
+			m_since=lockClock::now();
+			m_timed=true;
+			m_site->wait->observe(lockSeconds(begin, m_since));
+			m_site->contended.fetch_add(1, std::memory_order_relaxed);
+			m_site->acquisitions.fetch_add(1, std::memory_order_relaxed);
+			#else
+			m_mutex.lock();
+			#endif
+		}
+
+		bool try_lock()
+		{
+			if(!m_mutex.try_lock()){
+				return false;
+			}
+			#ifdef ENABLE_STOPWATCH
+			acquired();
+			#endif
+			return true;
+		}
+
+		void unlock()
+		{
+			#ifdef ENABLE_STOPWATCH
+			if(m_timed){
+				m_timed=false;
+				m_site->hold->observe(lockSeconds(m_since, lockClock::now()));
+			}
+			#endif
+			m_mutex.unlock();
+		}
+
+		void lock_shared()
+		{
+			#ifdef ENABLE_STOPWATCH
+			if(m_mutex.try_lock_shared()){
+				acquiredShared();
+				return;
+			}
+			lockClock::time_point begin=lockClock::now();
+			m_mutex.lock_shared();
+			lockClock::time_point since=lockClock::now();
+			m_site->sharedWait->observe(lockSeconds(begin, since));
+			m_site->sharedContended.fetch_add(1, std::memory_order_relaxed);
+			m_site->sharedAcquisitions.fetch_add(1, std::memory_order_relaxed);
+			timeShared(since);
+			#else
+			m_mutex.lock_shared();
+			#endif
+		}
+
+		bool try_lock_shared()
+		{
+			if(!m_mutex.try_lock_shared()){
+				return false;
+			}
+			#ifdef ENABLE_STOPWATCH
+			acquiredShared();
+			#endif
+			return true;
+		}
+
+		void unlock_shared()
+		{
+			#ifdef ENABLE_STOPWATCH
+			SharedHolds& holds=sharedHolds;
+			for(unsigned i=holds.count; i>0; i--){
+				if(holds.holds[i-1].mutex==this){
+					m_site->sharedHold->observe(lockSeconds(holds.holds[i-1].since, lockClock::now()));
+					holds.holds[i-1]=holds.holds[--holds.count];
+					break;
+				}
+			}
+			#endif
+			m_mutex.unlock_shared();
+		}
+
+		const LockSite* site() const
+		{
+			return m_site;
+		}
+
+	private:
+		std::shared_mutex m_mutex{};
+		LockSite* m_site{nullptr};
+		// shared acquisitions are counted by all their holders at once
+		std::atomic<std::uint64_t> m_sharedUncontended{0};
+		// the members below are only used by the exclusive holder
+		lockClock::time_point m_since{};
+		unsigned m_uncontended{0};
+		unsigned m_unsampled{0};
+		unsigned m_sampling{0};
+		bool m_timed{false};
+
+		void acquired()
+		{
+			if(++m_uncontended==LockSite::BATCH){
+				m_site->acquisitions.fetch_add(LockSite::BATCH, std::memory_order_relaxed);
+				m_uncontended=0;
+			}
+			if(m_sampling>0 && ++m_unsampled>=m_sampling){
+				m_unsampled=0;
+				m_since=lockClock::now();
+				m_timed=true;
+			}
+		}
+
+		void acquiredShared()
+		{
+			std::uint64_t count=m_sharedUncontended.fetch_add(1, std::memory_order_relaxed)+1;
+			if(count%LockSite::BATCH==0){
+				m_site->sharedAcquisitions.fetch_add(LockSite::BATCH, std::memory_order_relaxed);
+			}
+			if(m_sampling>0 && count%m_sampling==0){
+				timeShared(lockClock::now());
+			}
+		}
+
+		void timeShared(lockClock::time_point since)
+		{
+			SharedHolds& holds=sharedHolds;
+			if(holds.count<SharedHolds::CAPACITY){
+				holds.holds[holds.count++]=SharedHold{this, since};
+			}
+		}
+};
+
+//====================================================================
+
+/*
+ * A line per lock site: acquisitions, how many waited, and the median
+ * and p99 of wait and hold times, as upper bounds of their buckets.
+ *
+ * */
+inline void printLockContention(std::ostream& out=std::cout)
+{
+	std::ios_base::fmtflags f(out.flags());
+	out<<std::left<<std::setw(28)<<"lock site"<<std::right;
+	out<<std::setw(14)<<"acquisitions"<<std::setw(10)<<"waited";
+	out<<std::setw(12)<<"wait p50"<<std::setw(12)<<"wait p99";
+	out<<std::setw(12)<<"hold p50"<<std::setw(12)<<"hold p99"<<"\n";
+
+	auto line=[&out](const std::string& name, std::uint64_t acquisitions, std::uint64_t contended, const MetricsHistogram& wait, const MetricsHistogram& hold){
+		MetricsHistogram::Snapshot waits=wait.snapshot();
+		MetricsHistogram::Snapshot holds=hold.snapshot();
+		out<<std::left<<std::setw(28)<<name<<std::right;
+		out<<std::setw(14)<<acquisitions<<std::fixed<<std::setprecision(2);
+		out<<std::setw(9)<<(acquisitions>0 ? 100.0*contended/acquisitions : 0.0)<<"%";
+		out<<std::setprecision(3);
+		out<<std::setw(12)<<1e6*bucketQuantile(waits, 0.5)<<std::setw(12)<<1e6*bucketQuantile(waits, 0.99);
+		out<<std::setw(12)<<1e6*bucketQuantile(holds, 0.5)<<std::setw(12)<<1e6*bucketQuantile(holds, 0.99)<<" μs\n";
+	};
+
+	for(const LockSite* site : lockSites().sites()){
+		line(site->name, site->acquisitions.load(std::memory_order_relaxed), site->contended.load(std::memory_order_relaxed), *site->wait, *site->hold);
+		if(site->sharedWait){
+			line(site->name+" (shared)", site->sharedAcquisitions.load(std::memory_order_relaxed), site->sharedContended.load(std::memory_order_relaxed), *site->sharedWait, *site->sharedHold);
+		}
+	}
+	out.flags(f);
+}
+
+//====================================================================
+
+}
+
+#endif
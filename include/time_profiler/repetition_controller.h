@@ -0,0 +1,178 @@
+/*********************************************************************
+* RepetitionController decides when a region has been sampled enough.*
+*                                                                    *
+* Instead of a fixed number of repetitions, sampling continues until *
+* the confidence interval of the mean (Student's t) or the median    *
+* (bootstrap) is narrower than a target relative width, or the time  *
+* budget runs out.                                                   *
+*                                                                    *
+* Version: 1.0                                                       *
+* Date:    16-10-2026                                                *
+* Author:  Dan Machado                                               *
+**********************************************************************/
+#ifndef TIME_PROFILER_REPETITION_CONTROLLER_H
+#define TIME_PROFILER_REPETITION_CONTROLLER_H
+
+#include <chrono>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "statistics.h"
+
+//====================================================================
+
+namespace tprofiler
+{
+	enum class Estimator
+	{
+		Mean,
+		Median
+	};
+
+	struct StoppingRule
+	{
+		Estimator estimator{Estimator::Median};
+		double confidenceLevel{0.95};
+		double targetRelativeWidth{0.02}; // width of the interval over the estimate
+		double timeBudget{10};            // seconds
+		std::size_t minRepetitions{10};
+		std::size_t maxRepetitions{1000000};
+	};
+
+//====================================================================
+
+/*
+ * Example:
+ *
+ * tprofiler::TimeProfiler<std::chrono::microseconds> timeProfiler("parse", "#e6194b", "/tmp");
+ * tprofiler::RepetitionController controller;
+ *
+ * while(controller.keepGoing(timeProfiler.samples())){
+ *    timeProfiler.start();
+ *    parse(document);
+ *    timeProfiler.takeSample();
+ * }
+ *
+ * timeProfiler.addHeader("confidence", controller.toJson());
+ *
+ * */
+
+class RepetitionController
+{
+	public:
+		explicit RepetitionController(const StoppingRule& rule=StoppingRule())
+		: m_rule(rule)
+		{
+		}
+
+		/*
+		 * Check whether more samples are needed. The interval is only
+		 * recomputed when the number of samples has grown by about 10%,
+		 * so the check stays cheap compared with the region sampled.
+		 *
+		 * @param samples all the samples taken so far
+		 * @return false when the target width was reached, the budget
+		 *         (time or repetitions) is exhausted, or no sample was
+		 *         recorded by the first repetition. The budget is checked
+		 *         before minRepetitions.
+		 * */
+		bool keepGoing(const std::vector<double>& samples);
+
+		const stats::Estimate& estimate() const
+		{
+			return m_estimate;
+		}
+
+		bool converged() const
+		{
+			return m_converged;
+		}
+
+		/*
+		 * Achieved confidence as a JSON object for the dataset header.
+		 *
+		 * */
+		std::string toJson() const;
+
+	private:
+		StoppingRule m_rule;
+		stats::Estimate m_estimate{};
+		std::chrono::steady_clock::time_point m_start{};
+		std::size_t m_nextCheck{0};
+		std::size_t m_repetitions{0};
+		bool m_started{false};
+		bool m_converged{false};
+
+		void update(const std::vector<double>& samples)
+		{
+			if(m_rule.estimator==Estimator::Mean){
+				m_estimate=stats::meanConfidenceInterval(samples, m_rule.confidenceLevel);
+			}
+			else{
+				m_estimate=stats::bootstrapMedianInterval(samples, m_rule.confidenceLevel);
+			}
+			m_converged=samples.size()>1 && m_estimate.relativeWidth()<=m_rule.targetRelativeWidth;
+		}
+};
+
+//--------------------------------------------------------------------
+
+inline bool RepetitionController::keepGoing(const std::vector<double>& samples)
+{
+	if(!m_started){
+		m_started=true;
+		m_start=std::chrono::steady_clock::now();
+		m_nextCheck=m_rule.minRepetitions;
+		m_repetitions=samples.size();
+		return m_repetitions<m_rule.maxRepetitions;
+	}
+
+	// nothing is recorded, ie without ENABLE_STOPWATCH
+	if(samples.empty()){
+		return false;
+	}
+
+	m_repetitions=samples.size();
+	bool outOfBudget=m_repetitions>=m_rule.maxRepetitions
+		|| std::chrono::duration<double>(std::chrono::steady_clock::now()-m_start).count()>=m_rule.timeBudget;
+
+	if(outOfBudget){
+		update(samples);
+		return false;
+	}
+
+	if(m_repetitions<m_rule.minRepetitions){
+		return true;
+	}
+
+	if(m_repetitions>=m_nextCheck){
+		update(samples);
+		m_nextCheck=m_repetitions+std::max<std::size_t>(1, m_repetitions/10);
+	}
+
+	return !m_converged;
+}
+
+//--------------------------------------------------------------------
+
+inline std::string RepetitionController::toJson() const
+{
+	std::ostringstream json;
+	json<<"{\"estimator\": \""<<(m_rule.estimator==Estimator::Mean ? "mean" : "median")<<"\"";
+	json<<", \"level\": "<<m_rule.confidenceLevel;
+	json<<", \"estimate\": "<<m_estimate.value;
+	json<<", \"lower\": "<<m_estimate.lower;
+	json<<", \"upper\": "<<m_estimate.upper;
+	json<<", \"relativeWidth\": "<<m_estimate.relativeWidth();
+	json<<", \"target\": "<<m_rule.targetRelativeWidth;
+	json<<", \"repetitions\": "<<m_repetitions;
+	json<<", \"converged\": "<<(m_converged ? "true" : "false")<<"}";
+	return json.str();
+}
+
+//====================================================================
+
+}
+
+#endif
@@ -0,0 +1,284 @@
+/*********************************************************************
+* Run metadata for the time profiler datasets.                       *
+*                                                                    *
+* Captures the conditions of a run (CPU model, frequency governor,   *
+* turbo, isolated cores, load average, compiler and build flags) and *
+* measures the idle-loop jitter as a noise floor, warning when the   *
+* results are likely to be unreliable.                               *
+*                                                                    *
+* Version: 1.0                                                       *
+* Date:    16-10-2026                                                *
+* Author:  Dan Machado                                               *
+**********************************************************************/
+#ifndef TIME_PROFILER_RUN_METADATA_H
+#define TIME_PROFILER_RUN_METADATA_H
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// the build system can describe the build precisely, e.g. in CMake:
+// add_definitions(-DTPROFILER_CXX_FLAGS="${CMAKE_CXX_FLAGS}" -DTPROFILER_BUILD_TYPE="${CMAKE_BUILD_TYPE}")
+#ifndef TPROFILER_BUILD_TYPE
+	#if !defined(__OPTIMIZE__)
+		#define TPROFILER_BUILD_TYPE "Debug"
+	#elif defined(NDEBUG)
+		#define TPROFILER_BUILD_TYPE "Release"
+	#else
+		#define TPROFILER_BUILD_TYPE "Optimized"
+	#endif
+#endif
+
+//====================================================================
+
+namespace tprofiler
+{
+	struct NoiseFloor
+	{
+		double medianGap{0};   // ns between consecutive clock reads
+		double p999Gap{0};     // ns
+		double maxGap{0};      // ns
+		long long interruptions{0}; // gaps longer than 10 microseconds
+	};
+
+	struct RunMetadata
+	{
+		std::string cpuModel{};
+		unsigned cpus{0};
+		std::string governor{};
+		std::string turbo{};       // "enabled", "disabled" or "unknown"
+		std::string isolatedCpus{};
+		double loadAverage[3]{0, 0, 0};
+		std::string compiler{};
+		std::string flags{};
+		std::string buildType{};
+		bool optimized{false};     // __OPTIMIZE__, whatever the build type says
+		bool assertions{true};     // NDEBUG not defined
+		NoiseFloor noise{};
+		std::vector<std::string> warnings{};
+
+		std::string toJson() const;
+	};
+
+	inline namespace internal
+	{
+		inline void writeJsonString(std::ostream& out, const std::string& str)
+		{
+			out<<'"';
+			for(char c : str){
+				if(c=='"' || c=='\\'){
+					out<<'\\'<<c;
+				}
+				else if(static_cast<unsigned char>(c)<0x20){
+					out<<' ';
+				}
+				else{
+					out<<c;
+				}
+			}
+			out<<'"';
+		}
+
+		inline std::string readFirstLine(const std::string& path)
+		{
+			std::ifstream file(path);
+			std::string line;
+			std::getline(file, line);
+			return line;
+		}
+
+		inline std::string cpuModel()
+		{
+			std::ifstream cpuinfo("/proc/cpuinfo");
+			std::string line;
+			while(std::getline(cpuinfo, line)){
+				if(line.compare(0, 10, "model name")==0){
+					std::size_t colon=line.find(':');
+					if(colon!=std::string::npos){
+						return line.substr(line.find_first_not_of(' ', colon+1));
+					}
+				}
+			}
+			return "unknown";
+		}
+
+		inline std::string turboState()
+		{
+			std::string noTurbo=readFirstLine("/sys/devices/system/cpu/intel_pstate/no_turbo");
+			if(!noTurbo.empty()){
+				return noTurbo=="1" ? "disabled" : "enabled";
+			}
+
+			std::string boost=readFirstLine("/sys/devices/system/cpu/cpufreq/boost");
+			if(!boost.empty()){
+				return boost=="1" ? "enabled" : "disabled";
+			}
+			return "unknown";
+		}
+
+		inline std::string compilerFlags()
+		{
+			#ifdef TPROFILER_CXX_FLAGS
+			return TPROFILER_CXX_FLAGS;
+			#else
+			std::string flags;
+			#if defined(__OPTIMIZE_SIZE__)
+			flags.append("-Os");
+			#elif defined(__OPTIMIZE__)
+			flags.append("-O2+");
+			#else
+			flags.append("-O0");
+			#endif
+			#ifdef __AVX2__
+			flags.append(" -mavx2");
+			#endif
+			#ifdef __SANITIZE_ADDRESS__
+			flags.append(" -fsanitize=address");
+			#endif
+			#ifdef NDEBUG
+			flags.append(" -DNDEBUG");
+			#endif
+			return flags;
+			#endif
+		}
+
+		/*
+		 * Spin reading the clock for the given time and look at the gaps
+		 * between consecutive reads: preemptions, interrupts and frequency
+		 * transitions all show up as long gaps.
+		 *
+		 * */
+		inline NoiseFloor measureNoiseFloor(std::chrono::microseconds duration=std::chrono::microseconds(5000))
+		{
+			std::vector<double> gaps;
+			gaps.reserve(1<<16);
+			auto start=std::chrono::steady_clock::now();
+			auto previous=start;
+			while(previous-start<duration){
+				auto now=std::chrono::steady_clock::now();
+				gaps.push_back(std::chrono::duration<double, std::nano>(now-previous).count());
+				previous=now;
+			}
+
+			NoiseFloor noise;
+			if(gaps.empty()){
+				return noise;
+			}
+
+			std::sort(gaps.begin(), gaps.end());
+			noise.medianGap=gaps[gaps.size()/2];
+			noise.p999Gap=gaps[std::min(gaps.size()-1, gaps.size()*999/1000)];
+			noise.maxGap=gaps.back();
+			noise.interruptions=gaps.end()-std::upper_bound(gaps.begin(), gaps.end(), 10000.0);
+			return noise;
+		}
+
+		inline RunMetadata captureRunMetadata()
+		{
+			RunMetadata metadata;
+			metadata.cpuModel=cpuModel();
+			metadata.cpus=std::thread::hardware_concurrency();
+			metadata.governor=readFirstLine("/sys/devices/system/cpu/cpu0/cpufreq/scaling_governor");
+			metadata.turbo=turboState();
+			metadata.isolatedCpus=readFirstLine("/sys/devices/system/cpu/isolated");
+
+			std::istringstream loadavg(readFirstLine("/proc/loadavg"));
+			loadavg>>metadata.loadAverage[0]>>metadata.loadAverage[1]>>metadata.loadAverage[2];
+
+			#if defined(__clang__)
+			metadata.compiler=std::string("clang ")+__clang_version__;
+			#elif defined(__GNUC__)
+			metadata.compiler=std::string("gcc ")+__VERSION__;
+			#else
+			metadata.compiler="unknown";
+			#endif
+			metadata.flags=compilerFlags();
+			metadata.buildType=TPROFILER_BUILD_TYPE;
+			#ifdef __OPTIMIZE__
+			metadata.optimized=true;
+			#endif
+			#ifdef NDEBUG
+			metadata.assertions=false;
+			#endif
+			metadata.noise=measureNoiseFloor();
+
+			if(!metadata.governor.empty() && metadata.governor!="performance"){
+				metadata.warnings.push_back("CPU frequency governor is '"+metadata.governor+"', not 'performance'");
+			}
+			if(metadata.turbo=="enabled"){
+				metadata.warnings.push_back("turbo boost is enabled, the clock frequency depends on temperature and load");
+			}
+			if(metadata.cpus>0 && metadata.loadAverage[0]>0.5*metadata.cpus){
+				metadata.warnings.push_back("load average "+std::to_string(metadata.loadAverage[0])+" on "+std::to_string(metadata.cpus)+" cpus, other processes compete for the CPU");
+			}
+			if(metadata.noise.maxGap>100000){
+				metadata.warnings.push_back("idle loop stalled for "+std::to_string(static_cast<long long>(metadata.noise.maxGap/1000))+" us, expect outliers of that size");
+			}
+			if(!metadata.optimized){
+				metadata.warnings.push_back("not an optimized build ("+metadata.flags+")");
+			}
+			return metadata;
+		}
+	}
+
+	/*
+	 * Metadata of the current process, captured (and the warnings
+	 * printed) on first use.
+	 *
+	 * */
+	inline const RunMetadata& runMetadata()
+	{
+		static const RunMetadata metadata=[]{
+			RunMetadata captured=captureRunMetadata();
+			for(const std::string& warning : captured.warnings){
+				std::cout<<"Time profiler warning: "<<warning<<"\n";
+			}
+			return captured;
+		}();
+		return metadata;
+	}
+
+//--------------------------------------------------------------------
+
+	inline std::string RunMetadata::toJson() const
+	{
+		std::ostringstream json;
+		json<<"{\"cpuModel\": ";
+		writeJsonString(json, cpuModel);
+		json<<", \"cpus\": "<<cpus;
+		json<<", \"governor\": ";
+		writeJsonString(json, governor.empty() ? "unknown" : governor);
+		json<<", \"turbo\": ";
+		writeJsonString(json, turbo);
+		json<<", \"isolatedCpus\": ";
+		writeJsonString(json, isolatedCpus);
+		json<<", \"loadAverage\": ["<<loadAverage[0]<<", "<<loadAverage[1]<<", "<<loadAverage[2]<<"]";
+		json<<", \"compiler\": ";
+		writeJsonString(json, compiler);
+		json<<", \"flags\": ";
+		writeJsonString(json, flags);
+		json<<", \"buildType\": ";
+		writeJsonString(json, buildType);
+		json<<", \"optimized\": "<<(optimized ? "true" : "false");
+		json<<", \"assertions\": "<<(assertions ? "true" : "false");
+		json<<", \"noiseFloor\": {\"medianGapNs\": "<<noise.medianGap<<", \"p999GapNs\": "<<noise.p999Gap;
+		json<<", \"maxGapNs\": "<<noise.maxGap<<", \"interruptions\": "<<noise.interruptions<<"}";
+		json<<", \"warnings\": [";
+		for(std::size_t i=0; i<warnings.size(); i++){
+			json<<(i>0 ? ", " : "");
+			writeJsonString(json, warnings[i]);
+		}
+		json<<"]}";
+		return json.str();
+	}
+
+//====================================================================
+
+}
+
+#endif
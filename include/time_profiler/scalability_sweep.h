@@ -0,0 +1,298 @@
+/*********************************************************************
+* ScalabilitySweep measures how a workload scales with threads.      *
+*                                                                    *
+* The workload is run with 1..N threads (optionally pinned to CPUs), *
+* every thread records its latency through its own TimeProfiler, and *
+* the aggregate throughput gives the speedup and efficiency curves,  *
+* written with the ideal linear reference for the visualizer.        *
+*                                                                    *
+* Version: 1.0                                                       *
+* Date:    16-10-2026                                                *
+* Author:  Dan Machado                                               *
+**********************************************************************/
+#ifndef TIME_PROFILER_SCALABILITY_SWEEP_H
+#define TIME_PROFILER_SCALABILITY_SWEEP_H
+
+#include <atomic>
+#include <thread>
+
+#ifdef __linux__
+	#include <pthread.h>
+	#include <sched.h>
+#endif
+
+#include "benchmark.h"
+
+//====================================================================
+
+namespace tprofiler
+{
+	inline namespace internal
+	{
+		/*
+		 * Pin the calling thread to one CPU.
+		 *
+		 * @return false if pinning is not supported or failed
+		 * */
+		inline bool pinThread([[maybe_unused]] unsigned cpu)
+		{
+			#ifdef __linux__
+			cpu_set_t cpuSet;
+			CPU_ZERO(&cpuSet);
+			CPU_SET(cpu, &cpuSet);
+			return pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpuSet)==0;
+			#else
+			return false;
+			#endif
+		}
+	}
+
+//====================================================================
+
+/*
+ * Example:
+ *
+ * tprofiler::ScalabilitySweep<std::chrono::nanoseconds> sweep("hashmap insert", "#3cb44b", "/tmp");
+ * sweep.setPinning(true);
+ *
+ * sweep.run(tprofiler::ScalabilitySweep<std::chrono::nanoseconds>::powersOfTwo(64), [&](unsigned thread){
+ *    table.insert(randomKey(thread));
+ * }, 1000000);
+ *
+ * */
+
+template<typename TM>
+class ScalabilitySweep
+{
+	public:
+		// operations timed one by one per thread and run, evenly spread
+		static constexpr long long LATENCY_SAMPLES=10000;
+
+		/*
+		 * Constructor
+		 *
+		 * @param name a string to identify the datasets
+		 * @param colour the colour of the measured curves
+		 * @param outputDir path to the directory where the js files will
+		 *        be created. If empty no file is created.
+		 * */
+		ScalabilitySweep(const char* name, const char* colour, const char* outputDir="")
+		: m_name(name)
+		, m_colour(colour)
+		, m_outputDir(outputDir)
+		{
+		}
+
+		/*
+		 * 1, 2, 4... up to maxThreads, maxThreads included.
+		 *
+		 * */
+		static std::vector<unsigned> powersOfTwo(unsigned maxThreads=std::thread::hardware_concurrency())
+		{
+			std::vector<unsigned> counts;
+			for(unsigned n=1; n<maxThreads; n*=2){
+				counts.push_back(n);
+			}
+			counts.push_back(std::max(maxThreads, 1u));
+			return counts;
+		}
+
+		/*
+		 * Pin thread i to CPU i (modulo the number of CPUs).
+		 *
+		 * */
+		void setPinning(bool pin)
+		{
+			m_pin=pin;
+		}
+
+		/*
+		 * Run the workload at each thread count and write the datasets.
+		 *
+		 * @param threadCounts number of threads of each run, ascending
+		 * @param workload callable taking the thread index, one operation
+		 * @param operationsPerThread operations done by every thread per run
+		 * */
+		template<typename F>
+		void run(const std::vector<unsigned>& threadCounts, F workload, long long operationsPerThread);
+
+	private:
+		struct Run
+		{
+			unsigned threads{0};
+			double throughput{0};                 // operations per second, all threads
+			std::vector<double> threadThroughput{};
+			std::vector<double> latencies{};      // sampled operations, all threads
+		};
+
+		std::string m_name;
+		std::string m_colour;
+		std::string m_outputDir;
+		std::vector<Run> m_runs{};
+		bool m_pin{false};
+
+		template<typename F>
+		Run runThreads(unsigned threads, F& workload, long long operations);
+		void write() const;
+};
+
+//--------------------------------------------------------------------
+
+template<typename TM>
+template<typename F>
+typename ScalabilitySweep<TM>::Run ScalabilitySweep<TM>::runThreads(unsigned threads, F& workload, long long operations)
+{
+	const long long stride=std::max(1LL, operations/LATENCY_SAMPLES);
+	const unsigned cpus=std::max(1u, std::thread::hardware_concurrency());
+
+	std::vector<std::unique_ptr<TimeProfiler<TM>>> profilers;
+	for(unsigned i=0; i<threads; i++){
+		profilers.push_back(std::make_unique<TimeProfiler<TM>>(m_name.c_str(), m_colour.c_str()));
+	}
+
+	Run run;
+	run.threads=threads;
+	run.threadThroughput.resize(threads);
+
+	std::atomic<unsigned> ready{0};
+	std::atomic<bool> go{false};
+	std::vector<std::thread> pool;
+	for(unsigned t=0; t<threads; t++){
+		pool.emplace_back([&, t]{
+			if(m_pin){
+				pinThread(t%cpus);
+			}
+
+			ready.fetch_add(1);
+			while(!go.load(std::memory_order_acquire)){
+				std::this_thread::yield();
+			}
+
+			TimeProfiler<TM>& profiler=*profilers[t];
+			auto threadStart=std::chrono::steady_clock::now();
+			// the clock is only read around the sampled operations
+			for(long long done=0; done<operations; done+=stride){
+				profiler.start();
+				workload(t);
+				clobberMemory();
+				profiler.takeSample();
+
+				long long skipped=std::min(stride, operations-done);
+				for(long long i=1; i<skipped; i++){
+					workload(t);
+					clobberMemory();
+				}
+			}
+			double seconds=secondsSince(threadStart);
+			run.threadThroughput[t]=seconds>0 ? operations/seconds : 0;
+		});
+	}
+
+	while(ready.load()<threads){
+		std::this_thread::yield();
+	}
+
+	auto start=std::chrono::steady_clock::now();
+	go.store(true, std::memory_order_release);
+	for(std::thread& thread : pool){
+		thread.join();
+	}
+	double seconds=secondsSince(start);
+
+	run.throughput=seconds>0 ? threads*operations/seconds : 0;
+	for(const auto& profiler : profilers){
+		run.latencies.insert(run.latencies.end(), profiler->samples().begin(), profiler->samples().end());
+	}
+	return run;
+}
+
+//--------------------------------------------------------------------
+
+template<typename TM>
+template<typename F>
+void ScalabilitySweep<TM>::run(const std::vector<unsigned>& threadCounts, F workload, long long operationsPerThread)
+{
+	m_runs.clear();
+	for(unsigned threads : threadCounts){
+		if(threads>0){
+			m_runs.push_back(runThreads(threads, workload, operationsPerThread));
+		}
+	}
+
+	if(m_runs.empty()){
+		return;
+	}
+
+	std::ios_base::fmtflags f(std::cout.flags());
+	const Run& base=m_runs.front();
+	std::cout<<std::setw(8)<<"threads"<<std::setw(16)<<"ops/s"<<std::setw(10)<<"speedup"<<std::setw(12)<<"efficiency"<<"\n";
+	for(const Run& run : m_runs){
+		double speedup=base.throughput>0 ? run.throughput/base.throughput : 0;
+		std::cout<<std::setw(8)<<run.threads<<std::setw(16)<<std::fixed<<std::setprecision(0)<<run.throughput;
+		std::cout<<std::setw(10)<<std::setprecision(2)<<speedup;
+		std::cout<<std::setw(12)<<speedup*base.threads/run.threads<<"\n";
+	}
+	std::cout.flags(f);
+
+	write();
+}
+
+//--------------------------------------------------------------------
+
+template<typename TM>
+void ScalabilitySweep<TM>::write() const
+{
+	if(m_outputDir.empty()){
+		return;
+	}
+
+	const Run& base=m_runs.front();
+	std::vector<double> counts, speedup, ideal, efficiency, medians, p99;
+	std::vector<std::string> labels;
+	for(const Run& run : m_runs){
+		double s=base.throughput>0 ? run.throughput/base.throughput : 0;
+		double n=static_cast<double>(run.threads)/base.threads;
+		counts.push_back(run.threads);
+		labels.push_back(std::to_string(run.threads));
+		speedup.push_back(s);
+		ideal.push_back(n);
+		efficiency.push_back(s/n);
+
+		std::vector<double> sorted=run.latencies;
+		std::sort(sorted.begin(), sorted.end());
+		medians.push_back(stats::sortedQuantile(sorted, 0.5));
+		p99.push_back(stats::sortedQuantile(sorted, 0.99));
+	}
+
+	{
+		DataSetWriter<TM> writer(m_outputDir.c_str(), (m_name+"_speedup").c_str());
+		writer.setXAxis("Threads", counts, labels);
+		writer.setYTitle("Speedup");
+		writer.addSeries((m_name+" speedup").c_str(), m_colour.c_str(), speedup);
+		writer.addSeries("ideal linear", "#808080", ideal);
+		writer.addSeries((m_name+" efficiency").c_str(), lighterColour(m_colour, 0.5).c_str(), efficiency);
+
+		std::ostringstream throughput;
+		throughput<<std::setprecision(10)<<"[";
+		for(std::size_t i=0; i<m_runs.size(); i++){
+			throughput<<(i>0 ? ", " : "")<<"{\"threads\": "<<m_runs[i].threads<<", \"opsPerSecond\": "<<m_runs[i].throughput;
+			throughput<<", \"perThread\": ";
+			writeJsonArray(throughput, m_runs[i].threadThroughput, m_runs[i].threadThroughput.size());
+			throughput<<"}";
+		}
+		throughput<<"]";
+		writer.addHeader("throughput", throughput.str());
+		writer.addHeader("pinned", m_pin ? "true" : "false");
+	}
+
+	DataSetWriter<TM> writer(m_outputDir.c_str(), (m_name+"_latency").c_str());
+	writer.setXAxis("Threads", counts, labels);
+	writer.addSeries((m_name+" median").c_str(), m_colour.c_str(), medians);
+	writer.addSeries((m_name+" p99").c_str(), lighterColour(m_colour, 0.5).c_str(), p99);
+}
+
+//====================================================================
+
+}
+
+#endif
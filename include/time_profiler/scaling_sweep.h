@@ -0,0 +1,298 @@
+/*********************************************************************
+* ScalingSweep measures time against input size.                     *
+*                                                                    *
+* A callable taking the input size is benchmarked at each size of a  *
+* range, the distribution of the times at each size is recorded and  *
+* the common complexity models are fitted by least squares, so an    *
+* accidental O(n^2) shows up as the best fitting curve.              *
+*                                                                    *
+* Version: 1.0                                                       *
+* Date:    16-10-2026                                                *
+* Author:  Dan Machado                                               *
+**********************************************************************/
+#ifndef TIME_PROFILER_SCALING_SWEEP_H
+#define TIME_PROFILER_SCALING_SWEEP_H
+
+#include "benchmark.h"
+
+//====================================================================
+
+namespace tprofiler
+{
+	struct ComplexityModel
+	{
+		const char* name;
+		double (*function)(double n);
+	};
+
+	inline const std::vector<ComplexityModel>& complexityModels()
+	{
+		static const std::vector<ComplexityModel> models={
+			{"O(1)", [](double){ return 1.0; }},
+			{"O(log n)", [](double n){ return std::log2(n); }},
+			{"O(n)", [](double n){ return n; }},
+			{"O(n log n)", [](double n){ return n*std::log2(n); }},
+			{"O(n^2)", [](double n){ return n*n; }},
+			{"O(n^3)", [](double n){ return n*n*n; }},
+		};
+		return models;
+	}
+
+	struct ComplexityFit
+	{
+		std::string model{};
+		double coefficient{0};   // t = intercept + coefficient*f(n)
+		double intercept{0};
+		double rms{0};           // root mean square error relative to the mean time
+	};
+
+	/*
+	 * Fit t = a + b*f(n) by least squares for the given model.
+	 *
+	 * */
+	inline ComplexityFit fitComplexity(const ComplexityModel& model, const std::vector<double>& sizes, const std::vector<double>& times)
+	{
+		ComplexityFit fit;
+		fit.model=model.name;
+		std::size_t count=std::min(sizes.size(), times.size());
+		if(count==0){
+			return fit;
+		}
+
+		double sumF=0, sumT=0, sumFF=0, sumFT=0;
+		for(std::size_t i=0; i<count; i++){
+			double f=model.function(sizes[i]);
+			sumF+=f;
+			sumT+=times[i];
+			sumFF+=f*f;
+			sumFT+=f*times[i];
+		}
+
+		double denominator=count*sumFF-sumF*sumF;
+		if(std::fabs(denominator)>1e-12*count*sumFF){
+			fit.coefficient=(count*sumFT-sumF*sumT)/denominator;
+			fit.intercept=(sumT-fit.coefficient*sumF)/count;
+		}
+		else{ // constant model
+			fit.coefficient=0;
+			fit.intercept=sumT/count;
+		}
+
+		double error=0;
+		for(std::size_t i=0; i<count; i++){
+			double residual=times[i]-(fit.intercept+fit.coefficient*model.function(sizes[i]));
+			error+=residual*residual;
+		}
+		double meanTime=sumT/count;
+		fit.rms=meanTime>0 ? std::sqrt(error/count)/meanTime : 0;
+		return fit;
+	}
+
+	/*
+	 * The model with the smallest error among those growing with n.
+	 *
+	 * */
+	inline ComplexityFit bestComplexity(const std::vector<double>& sizes, const std::vector<double>& times, std::vector<ComplexityFit>* allFits=nullptr)
+	{
+		ComplexityFit best;
+		bool found=false;
+		for(const ComplexityModel& model : complexityModels()){
+			ComplexityFit fit=fitComplexity(model, sizes, times);
+			if(allFits){
+				allFits->push_back(fit);
+			}
+			if(fit.coefficient<0){
+				continue;
+			}
+			if(!found || fit.rms<best.rms){
+				best=fit;
+				found=true;
+			}
+		}
+		return best;
+	}
+
+//====================================================================
+
+/*
+ * Example:
+ *
+ * tprofiler::ScalingSweep<std::chrono::microseconds> sweep("dedup", "#911eb4", "/tmp");
+ *
+ * sweep.run(tprofiler::ScalingSweep<std::chrono::microseconds>::geometric(1<<10, 1<<20), [&](std::size_t n){
+ *    return deduplicate(input.data(), n);
+ * });
+ *
+ * std::cout<<sweep.complexity().model<<"\n";
+ *
+ * */
+
+template<typename TM>
+class ScalingSweep
+{
+	public:
+		/*
+		 * Constructor
+		 *
+		 * @param name a string to identify the dataset
+		 * @param colour the colour of the median curve
+		 * @param outputDir path to the directory where the js file will
+		 *        be created. If empty no file is created.
+		 * @param settings warm-up, batch and repetition settings per size
+		 * */
+		ScalingSweep(const char* name, const char* colour, const char* outputDir="", const BenchmarkSettings& settings=BenchmarkSettings())
+		: m_name(name)
+		, m_colour(colour)
+		, m_outputDir(outputDir)
+		, m_settings(settings)
+		{
+		}
+
+		/*
+		 * Sizes from first to last (included) multiplying by factor.
+		 *
+		 * */
+		static std::vector<std::size_t> geometric(std::size_t first, std::size_t last, double factor=2)
+		{
+			std::vector<std::size_t> sizes;
+			double size=static_cast<double>(std::max<std::size_t>(first, 1));
+			while(size<=last){
+				std::size_t n=static_cast<std::size_t>(size);
+				if(sizes.empty() || sizes.back()!=n){
+					sizes.push_back(n);
+				}
+				size*=std::max(factor, 1.01);
+			}
+			return sizes;
+		}
+
+		/*
+		 * Benchmark the task at each size, fit the complexity models and
+		 * write the dataset.
+		 *
+		 * @param sizes input sizes, in ascending order
+		 * @param task callable taking the input size
+		 * */
+		template<typename F>
+		void run(const std::vector<std::size_t>& sizes, F task);
+
+		const ComplexityFit& complexity() const
+		{
+			return m_best;
+		}
+
+	private:
+		std::string m_name;
+		std::string m_colour;
+		std::string m_outputDir;
+		BenchmarkSettings m_settings;
+		std::vector<double> m_sizes{};
+		std::vector<std::vector<double>> m_samples{};
+		std::vector<ComplexityFit> m_fits{};
+		ComplexityFit m_best{};
+
+		void write() const;
+};
+
+//--------------------------------------------------------------------
+
+template<typename TM>
+template<typename F>
+void ScalingSweep<TM>::run(const std::vector<std::size_t>& sizes, F task)
+{
+	m_sizes.clear();
+	m_samples.clear();
+	m_fits.clear();
+
+	std::vector<double> medians;
+	for(std::size_t n : sizes){
+		auto runBatch=makeBatchRunner([&task, n]{ return task(n); });
+		TimeProfiler<TM> profiler(m_name.c_str(), m_colour.c_str());
+		std::string confidence;
+		long long iterations=warmUp(runBatch, m_settings);
+		measureBatches(profiler, runBatch, iterations, m_settings, confidence);
+
+		m_sizes.push_back(static_cast<double>(n));
+		m_samples.push_back(profiler.samples());
+		medians.push_back(stats::median(profiler.samples()));
+	}
+
+	m_best=bestComplexity(m_sizes, medians, &m_fits);
+
+	std::ios_base::fmtflags f(std::cout.flags());
+	std::cout<<m_name<<": "<<m_best.model<<" (relative rms "<<std::setprecision(3)<<m_best.rms<<")\n";
+	std::cout.flags(f);
+
+	write();
+}
+
+//--------------------------------------------------------------------
+
+template<typename TM>
+void ScalingSweep<TM>::write() const
+{
+	if(m_outputDir.empty()){
+		return;
+	}
+
+	std::vector<double> p10, medians, p90, fitted;
+	std::vector<std::string> labels;
+	const ComplexityModel* model=nullptr;
+	for(const ComplexityModel& m : complexityModels()){
+		if(m_best.model==m.name){
+			model=&m;
+		}
+	}
+
+	for(std::size_t i=0; i<m_sizes.size(); i++){
+		std::vector<double> sorted=m_samples[i];
+		std::sort(sorted.begin(), sorted.end());
+		p10.push_back(stats::sortedQuantile(sorted, 0.1));
+		medians.push_back(stats::sortedQuantile(sorted, 0.5));
+		p90.push_back(stats::sortedQuantile(sorted, 0.9));
+		fitted.push_back(model ? m_best.intercept+m_best.coefficient*model->function(m_sizes[i]) : 0);
+		labels.push_back(std::to_string(static_cast<std::size_t>(m_sizes[i])));
+	}
+
+	DataSetWriter<TM> writer(m_outputDir.c_str(), m_name.c_str());
+	writer.setXAxis("n", m_sizes, labels);
+	writer.addSeries((m_name+" median").c_str(), m_colour.c_str(), medians);
+	writer.addSeries((m_name+" p10").c_str(), lighterColour(m_colour, 0.5).c_str(), p10);
+	writer.addSeries((m_name+" p90").c_str(), lighterColour(m_colour, 0.5).c_str(), p90);
+	writer.addSeries(("fit "+m_best.model).c_str(), "#808080", fitted);
+
+	std::ostringstream complexity;
+	complexity<<"{\"best\": ";
+	writeJsonString(complexity, m_best.model);
+	complexity<<", \"coefficient\": "<<m_best.coefficient<<", \"intercept\": "<<m_best.intercept;
+	complexity<<", \"models\": [";
+	for(std::size_t i=0; i<m_fits.size(); i++){
+		if(i>0){
+			complexity<<", ";
+		}
+		complexity<<"{\"model\": ";
+		writeJsonString(complexity, m_fits[i].model);
+		complexity<<", \"rms\": "<<m_fits[i].rms<<"}";
+	}
+	complexity<<"]}";
+	writer.addHeader("complexity", complexity.str());
+
+	std::ostringstream distribution;
+	distribution<<"[";
+	for(std::size_t i=0; i<m_sizes.size(); i++){
+		if(i>0){
+			distribution<<", ";
+		}
+		distribution<<"{\"n\": "<<labels[i]<<", \"samples\": ";
+		writeJsonArray(distribution, m_samples[i], m_samples[i].size());
+		distribution<<"}";
+	}
+	distribution<<"]";
+	writer.addHeader("distribution", distribution.str());
+}
+
+//====================================================================
+
+}
+
+#endif
@@ -0,0 +1,185 @@
+/*********************************************************************
+* SharedCollector drains the shared-memory region the profilers of   *
+* many processes write to (see shared_region.h) into one dataset:    *
+* one series per profiler name, labelled with the process ID of      *
+* every sample.                                                      *
+*                                                                    *
+* Version: 1.0                                                       *
+* Date:    16-10-2026                                                *
+* Author:  Dan Machado                                               *
+**********************************************************************/
+#ifndef TIME_PROFILER_SHARED_COLLECTOR_H
+#define TIME_PROFILER_SHARED_COLLECTOR_H
+
+#include <algorithm>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <signal.h>
+
+#include "dataset_reader.h"
+#include "shared_region.h"
+
+//====================================================================
+
+namespace tprofiler
+{
+
+class SharedCollector
+{
+	public:
+		/*
+		 * @throws std::runtime_error if the region cannot be mapped
+		 * */
+		explicit SharedCollector(const std::string& region)
+		{
+			m_region.open(region);
+			m_sources.resize(m_region.slots());
+			for(std::uint32_t i=0; i<m_region.slots(); i++){
+				m_sources[i].droppedBefore=m_region.slot(i).dropped.load(std::memory_order_relaxed);
+			}
+		}
+
+		/*
+		 * Append the samples written since the last call to the series
+		 * of dataSet, always the same one. Slots whose profiler finished,
+		 * or whose process died, are freed once read.
+		 *
+		 * @return number of samples appended
+		 * */
+		std::size_t drain(DataSet& dataSet)
+		{
+			std::size_t appended=0;
+			for(std::uint32_t i=0; i<m_region.slots(); i++){
+				SharedSlot& slot=m_region.slot(i);
+				std::uint32_t state=slot.state.load(std::memory_order_acquire);
+				if(state!=SharedSlot::READY && state!=SharedSlot::CLOSED){
+					continue;
+				}
+
+				Source& source=m_sources[i];
+				std::uint32_t generation=slot.generation.load(std::memory_order_relaxed);
+				if(!source.known || source.generation!=generation){
+					attach(dataSet, slot, source, generation);
+				}
+
+				appended+=read(dataSet, i, source);
+				if(state==SharedSlot::CLOSED || !alive(slot.pid)){
+					std::uint32_t expected=state;
+					slot.state.compare_exchange_strong(expected, SharedSlot::FREE, std::memory_order_release);
+				}
+			}
+			return appended;
+		}
+
+		/*
+		 * Samples the profilers dropped since the collector was created
+		 * because their ring was full: it was not drained often enough.
+		 *
+		 * */
+		std::uint64_t dropped() const
+		{
+			std::uint64_t dropped=0;
+			for(std::uint32_t i=0; i<m_region.slots(); i++){
+				dropped+=m_region.slot(i).dropped.load(std::memory_order_relaxed)-m_sources[i].droppedBefore;
+			}
+			return dropped;
+		}
+
+	private:
+		struct Source
+		{
+			bool known{false};
+			std::uint32_t generation{0};
+			std::size_t series{0};
+			std::uint32_t label{0};
+			bool work{false};
+			std::uint64_t droppedBefore{0}; // of the slot, whoever owned it
+		};
+
+		SharedRegion m_region{};
+		std::vector<Source> m_sources{};
+		std::map<std::string, std::size_t> m_series{}; // name to series
+
+		static bool alive(std::int32_t pid)
+		{
+			return ::kill(pid, 0)==0 || errno!=ESRCH;
+		}
+
+		/*
+		 * Find the series of the profiler, or add it, and the label of
+		 * its process. Profilers in other time units get a series of
+		 * their own.
+		 *
+		 * */
+		void attach(DataSet& dataSet, const SharedSlot& slot, Source& source, std::uint32_t generation)
+		{
+			source.known=true;
+			source.generation=generation;
+
+			std::string name(slot.name);
+			std::string timeUnits(slot.timeUnits);
+			std::string workUnits(slot.workUnits);
+			if(dataSet.timeUnits.empty()){
+				dataSet.timeUnits=timeUnits;
+			}
+			if(dataSet.workUnits.empty()){
+				dataSet.workUnits=workUnits;
+			}
+			if(timeUnits!=dataSet.timeUnits){
+				name+=" ("+timeUnits+")";
+			}
+
+			auto found=m_series.find(name);
+			if(found==m_series.end()){
+				Series series;
+				series.name=name;
+				series.colour=slot.colour;
+				series.labelNames.emplace_back(""); // code 0: unlabelled samples
+				dataSet.series.push_back(std::move(series));
+				found=m_series.emplace(name, dataSet.series.size()-1).first;
+			}
+			source.series=found->second;
+			source.work=!workUnits.empty();
+
+			std::vector<std::string>& labelNames=dataSet.series[source.series].labelNames;
+			std::string label="pid "+std::to_string(slot.pid);
+			source.label=static_cast<std::uint32_t>(std::find(labelNames.begin(), labelNames.end(), label)-labelNames.begin());
+			if(source.label==labelNames.size()){
+				labelNames.push_back(label);
+			}
+		}
+
+		std::size_t read(DataSet& dataSet, std::uint32_t index, const Source& source)
+		{
+			SharedSlot& slot=m_region.slot(index);
+			const SharedSample* samples=m_region.samples(index);
+			std::uint64_t capacity=m_region.capacity();
+			std::uint64_t tail=slot.tail.load(std::memory_order_relaxed);
+			std::uint64_t head=slot.head.load(std::memory_order_acquire);
+
+			// profilers without work add none to the work column
+			Series& series=dataSet.series[source.series];
+			bool work=source.work || !series.work.empty();
+			if(work){
+				series.work.resize(series.data.size(), 0);
+			}
+			for(std::uint64_t i=tail; i<head; i++){
+				const SharedSample& sample=samples[i&(capacity-1)];
+				series.data.push_back(sample.value);
+				if(work){
+					series.work.push_back(sample.work);
+				}
+				series.labels.push_back(source.label);
+			}
+			slot.tail.store(head, std::memory_order_release);
+			return static_cast<std::size_t>(head-tail);
+		}
+};
+
+//====================================================================
+
+}
+
+#endif
@@ -0,0 +1,368 @@
+/*********************************************************************
+* Shared-memory region the profilers of many processes write their   *
+* samples into, for a collector to drain them into one dataset (see  *
+* shared_collector.h) instead of one file per process.               *
+*                                                                    *
+* The region is a POSIX shared memory object divided in slots. A     *
+* profiler claims a slot of its own and writes to its ring, the      *
+* collector reads every ring: each ring has one writer and one       *
+* reader, so neither locks. A full ring drops the new samples.       *
+*                                                                    *
+* Version: 1.0                                                       *
+* Date:    16-10-2026                                                *
+* Author:  Dan Machado                                               *
+**********************************************************************/
+#ifndef TIME_PROFILER_SHARED_REGION_H
+#define TIME_PROFILER_SHARED_REGION_H
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+//====================================================================
+
+namespace tprofiler
+{
+
+inline namespace internal
+{
+	static_assert(std::atomic<std::uint64_t>::is_always_lock_free, "shared rings need lock-free 64 bit atomics");
+
+	struct SharedSample
+	{
+		double value;
+		double work;
+	};
+
+	/*
+	 * A slot goes FREE -> CLAIMED -> READY -> CLOSED, and back to FREE
+	 * once the collector has read all of it. The generation changes
+	 * every time it is claimed, so the collector tells its owners apart.
+	 *
+	 * */
+	struct SharedSlot
+	{
+		enum State : std::uint32_t
+		{
+			FREE=0,
+			CLAIMED,
+			READY,
+			CLOSED
+		};
+
+		std::atomic<std::uint32_t> state;
+		std::atomic<std::uint32_t> generation;
+		std::int32_t pid;
+		std::int32_t tid;
+		char name[64];
+		char colour[16];
+		char timeUnits[16];
+		char workUnits[32];
+		alignas(64) std::atomic<std::uint64_t> head;    // written by the profiler
+		alignas(64) std::atomic<std::uint64_t> tail;    // written by the collector
+		alignas(64) std::atomic<std::uint64_t> dropped; // samples the ring had no room for, ever
+	};
+
+	struct SharedRegionHeader
+	{
+		enum State : std::uint32_t
+		{
+			EMPTY=0,
+			INITIALISING,
+			READY
+		};
+
+		std::atomic<std::uint32_t> state;
+		char magic[8];
+		std::uint32_t slots;
+		std::uint32_t capacity; // samples of a ring, a power of 2
+	};
+
+	inline void copyBounded(char* target, std::size_t size, const std::string& source)
+	{
+		std::size_t length=std::min(source.size(), size-1);
+		std::memcpy(target, source.data(), length);
+		target[length]='\0';
+	}
+}
+
+//--------------------------------------------------------------------
+
+/*
+ * Mapping of a region, created by whichever of the profilers and the
+ * collector opens it first. Its pages are only backed by memory as
+ * the slots are used.
+ *
+ * */
+class SharedRegion
+{
+	public:
+		static constexpr std::uint32_t SLOTS=128;
+		static constexpr std::uint32_t CAPACITY=8192;
+
+		SharedRegion()=default;
+		SharedRegion(const SharedRegion&)=delete;
+		SharedRegion& operator=(const SharedRegion&)=delete;
+
+		~SharedRegion()
+		{
+			close();
+		}
+
+		/*
+		 * @param name the region is /dev/shm/tprofiler_<name>
+		 * @throws std::runtime_error if it cannot be mapped or was made
+		 *         by an incompatible version
+		 * */
+		void open(const std::string& name)
+		{
+			close();
+			std::string object="/tprofiler_"+name;
+			int fd=::shm_open(object.c_str(), O_RDWR|O_CREAT|O_CLOEXEC, 0600);
+			if(fd<0){
+				throw std::runtime_error("cannot open shared region "+name+": "+std::strerror(errno));
+			}
+
+			std::size_t size=regionSize(SLOTS, CAPACITY);
+			struct stat status;
+			if(::fstat(fd, &status)<0 || (status.st_size==0 && ::ftruncate(fd, static_cast<off_t>(size))<0)){
+				int error=errno;
+				::close(fd);
+				throw std::runtime_error("cannot size shared region "+name+": "+std::strerror(error));
+			}
+			if(status.st_size!=0 && static_cast<std::size_t>(status.st_size)!=size){
+				::close(fd);
+				throw std::runtime_error("shared region "+name+" has an unknown layout");
+			}
+
+			void* address=::mmap(nullptr, size, PROT_READ|PROT_WRITE, MAP_SHARED, fd, 0);
+			::close(fd);
+			if(address==MAP_FAILED){
+				throw std::runtime_error("cannot map shared region "+name+": "+std::strerror(errno));
+			}
+			m_address=static_cast<char*>(address);
+			m_size=size;
+			initialise(name);
+		}
+
+		void close()
+		{
+			if(m_address!=nullptr){
+				::munmap(m_address, m_size);
+				m_address=nullptr;
+			}
+		}
+
+		bool isOpen() const
+		{
+			return m_address!=nullptr;
+		}
+
+		std::uint32_t slots() const
+		{
+			return header().slots;
+		}
+
+		std::uint32_t capacity() const
+		{
+			return header().capacity;
+		}
+
+		SharedSlot& slot(std::uint32_t index) const
+		{
+			return *reinterpret_cast<SharedSlot*>(m_address+slotOffset(index));
+		}
+
+		SharedSample* samples(std::uint32_t index) const
+		{
+			return reinterpret_cast<SharedSample*>(m_address+slotOffset(index)+sizeof(SharedSlot));
+		}
+
+		/*
+		 * Remove the name of the region, the processes that mapped it
+		 * keep using it.
+		 *
+		 * */
+		static void unlink(const std::string& name)
+		{
+			::shm_unlink(("/tprofiler_"+name).c_str());
+		}
+
+	private:
+		char* m_address{nullptr};
+		std::size_t m_size{0};
+
+		static std::size_t headerSize()
+		{
+			return (sizeof(SharedRegionHeader)+alignof(SharedSlot)-1)/alignof(SharedSlot)*alignof(SharedSlot);
+		}
+
+		static std::size_t regionSize(std::uint32_t slots, std::uint32_t capacity)
+		{
+			return headerSize()+slots*(sizeof(SharedSlot)+capacity*sizeof(SharedSample));
+		}
+
+		const SharedRegionHeader& header() const
+		{
+			return *reinterpret_cast<const SharedRegionHeader*>(m_address);
+		}
+
+		std::size_t slotOffset(std::uint32_t index) const
+		{
+			return headerSize()+index*(sizeof(SharedSlot)+header().capacity*sizeof(SharedSample));
+		}
+
+		/*
+		 * A new region is zero-filled: every slot is free, only the
+		 * header has to be written, by one of the processes.
+		 *
+		 * */
+		void initialise(const std::string& name)
+		{
+			SharedRegionHeader& header=*reinterpret_cast<SharedRegionHeader*>(m_address);
+			std::uint32_t state=SharedRegionHeader::EMPTY;
+			if(header.state.compare_exchange_strong(state, SharedRegionHeader::INITIALISING)){
+				std::memcpy(header.magic, "TPSHM01", 8);
+				header.slots=SLOTS;
+				header.capacity=CAPACITY;
+				header.state.store(SharedRegionHeader::READY, std::memory_order_release);
+				return;
+			}
+
+			for(int i=0; i<1000 && header.state.load(std::memory_order_acquire)!=SharedRegionHeader::READY; i++){
+				std::this_thread::sleep_for(std::chrono::milliseconds(1));
+			}
+			if(header.state.load(std::memory_order_acquire)!=SharedRegionHeader::READY || std::memcmp(header.magic, "TPSHM01", 8)!=0){
+				close();
+				throw std::runtime_error("shared region "+name+" has an unknown layout");
+			}
+		}
+};
+
+//--------------------------------------------------------------------
+
+/*
+ * The slot of one profiler, written by a single thread.
+ *
+ * */
+class SharedSlotWriter
+{
+	public:
+		SharedSlotWriter()=default;
+		SharedSlotWriter(const SharedSlotWriter&)=delete;
+		SharedSlotWriter& operator=(const SharedSlotWriter&)=delete;
+
+		~SharedSlotWriter()
+		{
+			close();
+		}
+
+		/*
+		 * Claim a free slot of the region.
+		 *
+		 * @throws std::runtime_error if the region cannot be mapped or
+		 *         has no free slot: no collector freed them
+		 * */
+		void open(const std::string& region, const std::string& name, const std::string& colour, const std::string& timeUnits, const std::string& workUnits)
+		{
+			close();
+			m_region.open(region);
+			for(std::uint32_t i=0; i<m_region.slots(); i++){
+				if(claim(i)){
+					SharedSlot& slot=m_region.slot(i);
+					slot.pid=static_cast<std::int32_t>(::getpid());
+					slot.tid=static_cast<std::int32_t>(::syscall(SYS_gettid));
+					copyBounded(slot.name, sizeof(slot.name), name);
+					copyBounded(slot.colour, sizeof(slot.colour), colour);
+					copyBounded(slot.timeUnits, sizeof(slot.timeUnits), timeUnits);
+					copyBounded(slot.workUnits, sizeof(slot.workUnits), workUnits);
+					slot.generation.fetch_add(1, std::memory_order_relaxed);
+					slot.state.store(SharedSlot::READY, std::memory_order_release);
+					m_slot=&slot;
+					m_samples=m_region.samples(i);
+					m_head=slot.head.load(std::memory_order_relaxed);
+					return;
+				}
+			}
+			m_region.close();
+			throw std::runtime_error("shared region "+region+" has no free slot");
+		}
+
+		bool isOpen() const
+		{
+			return m_slot!=nullptr;
+		}
+
+		/*
+		 * @return false if the ring was full and the sample dropped
+		 * */
+		bool push(double value, double work)
+		{
+			std::uint32_t capacity=m_region.capacity();
+			if(m_head-m_slot->tail.load(std::memory_order_acquire)>=capacity){
+				m_slot->dropped.fetch_add(1, std::memory_order_relaxed);
+				return false;
+			}
+			m_samples[m_head&(capacity-1)]=SharedSample{value, work};
+			m_head++;
+			return true;
+		}
+
+		/*
+		 * Make the samples pushed visible to the collector.
+		 *
+		 * */
+		void publish()
+		{
+			m_slot->head.store(m_head, std::memory_order_release);
+		}
+
+		/*
+		 * Hand the slot to the collector, which frees it once read.
+		 *
+		 * */
+		void close()
+		{
+			if(m_slot!=nullptr){
+				publish();
+				m_slot->state.store(SharedSlot::CLOSED, std::memory_order_release);
+				m_slot=nullptr;
+			}
+			m_region.close();
+		}
+
+	private:
+		SharedRegion m_region{};
+		SharedSlot* m_slot{nullptr};
+		SharedSample* m_samples{nullptr};
+		std::uint64_t m_head{0};
+
+		/*
+		 * Only the collector frees slots, closed ones once it has read
+		 * them. The ring continues from where the last owner left it.
+		 *
+		 * */
+		bool claim(std::uint32_t index)
+		{
+			std::uint32_t state=SharedSlot::FREE;
+			return m_region.slot(index).state.compare_exchange_strong(state, SharedSlot::CLAIMED, std::memory_order_acquire);
+		}
+};
+
+//====================================================================
+
+}
+
+#endif
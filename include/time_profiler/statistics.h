@@ -0,0 +1,343 @@
+/*********************************************************************
+* Statistics helpers used by the benchmark tools of the time profiler *
+* library: location and spread estimators over samples of elapsed   *
+* time.                                                              *
+*                                                                    *
+* Version: 1.0                                                       *
+* Date:    16-10-2026                                                *
+* Author:  Dan Machado                                               *
+**********************************************************************/
+#ifndef TIME_PROFILER_STATISTICS_H
+#define TIME_PROFILER_STATISTICS_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <utility>
+#include <vector>
+
+//====================================================================
+
+namespace tprofiler
+{
+namespace stats
+{
+	inline double mean(const std::vector<double>& samples)
+	{
+		if(samples.empty()){
+			return 0;
+		}
+
+		double sum=0;
+		for(double x : samples){
+			sum+=x;
+		}
+		return sum/samples.size();
+	}
+
+	/*
+	 * Sample standard deviation.
+	 * 
+	 * */
+	inline double standardDeviation(const std::vector<double>& samples)
+	{
+		if(samples.size()<2){
+			return 0;
+		}
+
+		double m=mean(samples);
+		double sum=0;
+		for(double x : samples){
+			sum+=(x-m)*(x-m);
+		}
+		return std::sqrt(sum/(samples.size()-1));
+	}
+
+	/*
+	 * Quantile of a sorted sequence, linear interpolation between 
+	 * closest ranks.
+	 * 
+	 * @param sorted samples sorted in ascending order
+	 * @param p probability in [0, 1]
+	 * */
+	inline double sortedQuantile(const std::vector<double>& sorted, double p)
+	{
+		if(sorted.empty()){
+			return 0;
+		}
+
+		double rank=std::clamp(p, 0.0, 1.0)*(sorted.size()-1);
+		std::size_t lower=static_cast<std::size_t>(rank);
+		if(lower+1>=sorted.size()){
+			return sorted.back();
+		}
+		double fraction=rank-lower;
+		return sorted[lower]+fraction*(sorted[lower+1]-sorted[lower]);
+	}
+
+	inline double quantile(std::vector<double> samples, double p)
+	{
+		std::sort(samples.begin(), samples.end());
+		return sortedQuantile(samples, p);
+	}
+
+	inline double median(const std::vector<double>& samples)
+	{
+		return quantile(samples, 0.5);
+	}
+
+	struct Interval
+	{
+		double lower{0};
+		double upper{0};
+	};
+
+	/*
+	 * Tukey's fences: [Q1-k*IQR, Q3+k*IQR]. Samples outside are 
+	 * considered outliers.
+	 * 
+	 * @param k 1.5 for outliers, 3 for far out values
+	 * */
+	inline Interval tukeyFences(std::vector<double> samples, double k=1.5)
+	{
+		std::sort(samples.begin(), samples.end());
+		double q1=sortedQuantile(samples, 0.25);
+		double q3=sortedQuantile(samples, 0.75);
+		double iqr=q3-q1;
+		return Interval{q1-k*iqr, q3+k*iqr};
+	}
+
+	/*
+	 * Quantile of the standard normal distribution (Acklam's rational
+	 * approximation, relative error below 1.2e-9).
+	 * 
+	 * */
+	inline double normalQuantile(double p)
+	{
+		static const double a[]={-3.969683028665376e+01, 2.209460984245205e+02, -2.759285104469687e+02, 1.383577518672690e+02, -3.066479806614716e+01, 2.506628277459239e+00};
+		static const double b[]={-5.447609879822406e+01, 1.615858368580409e+02, -1.556989798598866e+02, 6.680131188771972e+01, -1.328068155288572e+01};
+		static const double c[]={-7.784894002430293e-03, -3.223964580411365e-01, -2.400758277161838e+00, -2.549732539343734e+00, 4.374664141464968e+00, 2.938163982698783e+00};
+		static const double d[]={7.784695709041462e-03, 3.224671290700398e-01, 2.445134137142996e+00, 3.754408661907416e+00};
+
+		p=std::clamp(p, 1e-12, 1-1e-12);
+		if(p<0.02425){
+			double q=std::sqrt(-2*std::log(p));
+			return (((((c[0]*q+c[1])*q+c[2])*q+c[3])*q+c[4])*q+c[5])/((((d[0]*q+d[1])*q+d[2])*q+d[3])*q+1);
+		}
+		if(p>1-0.02425){
+			double q=std::sqrt(-2*std::log(1-p));
+			return -(((((c[0]*q+c[1])*q+c[2])*q+c[3])*q+c[4])*q+c[5])/((((d[0]*q+d[1])*q+d[2])*q+d[3])*q+1);
+		}
+		double q=p-0.5;
+		double r=q*q;
+		return (((((a[0]*r+a[1])*r+a[2])*r+a[3])*r+a[4])*r+a[5])*q/(((((b[0]*r+b[1])*r+b[2])*r+b[3])*r+b[4])*r+1);
+	}
+
+	/*
+	 * Quantile of Student's t distribution with dof degrees of freedom
+	 * (Cornish-Fisher expansion around the normal quantile, accurate to
+	 * about 1% from 3 degrees of freedom).
+	 * 
+	 * */
+	inline double studentQuantile(double p, double dof)
+	{
+		double z=normalQuantile(p);
+		if(dof<1){
+			return z;
+		}
+		double z3=z*z*z;
+		double z5=z3*z*z;
+		double z7=z5*z*z;
+		return z+(z3+z)/(4*dof)
+			+(5*z5+16*z3+3*z)/(96*dof*dof)
+			+(3*z7+19*z5+17*z3-15*z)/(384*dof*dof*dof);
+	}
+
+	struct Estimate
+	{
+		double value{0};
+		double lower{0};
+		double upper{0};
+
+		/*
+		 * Width of the interval relative to the estimate.
+		 * 
+		 * */
+		double relativeWidth() const
+		{
+			return value!=0 ? (upper-lower)/std::fabs(value) : 0;
+		}
+	};
+
+	/*
+	 * Confidence interval of the mean based on Student's t distribution.
+	 * 
+	 * @param level confidence level, e.g. 0.95
+	 * */
+	inline Estimate meanConfidenceInterval(const std::vector<double>& samples, double level=0.95)
+	{
+		Estimate estimate;
+		estimate.value=mean(samples);
+		estimate.lower=estimate.value;
+		estimate.upper=estimate.value;
+		if(samples.size()>1){
+			double t=studentQuantile(0.5+level/2, samples.size()-1);
+			double halfWidth=t*standardDeviation(samples)/std::sqrt(static_cast<double>(samples.size()));
+			estimate.lower-=halfWidth;
+			estimate.upper+=halfWidth;
+		}
+		return estimate;
+	}
+
+	/*
+	 * Median of a resample with replacement of samples, resample is
+	 * used as scratch space and has the size of samples.
+	 * 
+	 * */
+	inline double resampledMedian(const std::vector<double>& samples, std::vector<double>& resample, std::mt19937& generator)
+	{
+		std::uniform_int_distribution<std::size_t> pick(0, samples.size()-1);
+		for(double& x : resample){
+			x=samples[pick(generator)];
+		}
+		std::size_t middle=resample.size()/2;
+		std::nth_element(resample.begin(), resample.begin()+middle, resample.end());
+		double value=resample[middle];
+		if(resample.size()%2==0){
+			value=(value+*std::max_element(resample.begin(), resample.begin()+middle))/2;
+		}
+		return value;
+	}
+
+	/*
+	 * Percentile bootstrap confidence interval of the median.
+	 * 
+	 * @param level confidence level, e.g. 0.95
+	 * @param resamples number of bootstrap resamples
+	 * @param seed seed of the resampling generator, fixed for reproducibility
+	 * */
+	inline Estimate bootstrapMedianInterval(const std::vector<double>& samples, double level=0.95, int resamples=1000, std::uint32_t seed=5489u)
+	{
+		Estimate estimate;
+		estimate.value=median(samples);
+		estimate.lower=estimate.value;
+		estimate.upper=estimate.value;
+		if(samples.size()<2 || resamples<1){
+			return estimate;
+		}
+
+		std::mt19937 generator(seed);
+		std::vector<double> resample(samples.size());
+		std::vector<double> medians(resamples);
+		for(int i=0; i<resamples; i++){
+			medians[i]=resampledMedian(samples, resample, generator);
+		}
+
+		std::sort(medians.begin(), medians.end());
+		estimate.lower=sortedQuantile(medians, (1-level)/2);
+		estimate.upper=sortedQuantile(medians, 1-(1-level)/2);
+		return estimate;
+	}
+
+	/*
+	 * Percentile bootstrap confidence interval of the difference of
+	 * medians, median(candidate)-median(baseline), both samples being
+	 * resampled independently.
+	 * 
+	 * */
+	inline Estimate bootstrapMedianDifference(const std::vector<double>& baseline, const std::vector<double>& candidate, double level=0.95, int resamples=1000, std::uint32_t seed=5489u)
+	{
+		Estimate estimate;
+		estimate.value=median(candidate)-median(baseline);
+		estimate.lower=estimate.value;
+		estimate.upper=estimate.value;
+		if(baseline.size()<2 || candidate.size()<2 || resamples<1){
+			return estimate;
+		}
+
+		std::mt19937 generator(seed);
+		std::vector<double> baselineResample(baseline.size());
+		std::vector<double> candidateResample(candidate.size());
+		std::vector<double> differences(resamples);
+		for(int i=0; i<resamples; i++){
+			differences[i]=resampledMedian(candidate, candidateResample, generator)-resampledMedian(baseline, baselineResample, generator);
+		}
+
+		std::sort(differences.begin(), differences.end());
+		estimate.lower=sortedQuantile(differences, (1-level)/2);
+		estimate.upper=sortedQuantile(differences, 1-(1-level)/2);
+		return estimate;
+	}
+
+	struct RankTest
+	{
+		double u{0};       // Mann-Whitney U of the candidate sample
+		double z{0};       // normal approximation, positive if the candidate is larger
+		double pValue{1};  // two-sided
+	};
+
+	/*
+	 * Mann-Whitney U test (Wilcoxon rank-sum): are the values of one
+	 * sample systematically larger than those of the other? It makes no
+	 * assumption on the shape of the distributions, so it holds for the
+	 * skewed, long-tailed distributions of elapsed times. Normal
+	 * approximation with tie and continuity corrections.
+	 * 
+	 * */
+	inline RankTest mannWhitneyU(const std::vector<double>& baseline, const std::vector<double>& candidate)
+	{
+		RankTest test;
+		const double n1=static_cast<double>(baseline.size());
+		const double n2=static_cast<double>(candidate.size());
+		if(baseline.empty() || candidate.empty()){
+			return test;
+		}
+
+		// (value, sample) sorted by value, sample 1 is the candidate
+		std::vector<std::pair<double, int>> pooled;
+		pooled.reserve(baseline.size()+candidate.size());
+		for(double x : baseline){
+			pooled.emplace_back(x, 0);
+		}
+		for(double x : candidate){
+			pooled.emplace_back(x, 1);
+		}
+		std::sort(pooled.begin(), pooled.end());
+
+		double rankSum=0;
+		double ties=0;
+		for(std::size_t i=0; i<pooled.size(); ){
+			std::size_t j=i;
+			while(j<pooled.size() && pooled[j].first==pooled[i].first){
+				j++;
+			}
+			double rank=(i+1+j)/2.0; // average of ranks i+1..j
+			for(std::size_t k=i; k<j; k++){
+				if(pooled[k].second==1){
+					rankSum+=rank;
+				}
+			}
+			double t=static_cast<double>(j-i);
+			ties+=t*t*t-t;
+			i=j;
+		}
+
+		const double n=n1+n2;
+		test.u=rankSum-n2*(n2+1)/2;
+		const double expected=n1*n2/2;
+		const double variance=n1*n2/12*((n+1)-ties/(n*(n-1)));
+		if(variance<=0){
+			return test;
+		}
+
+		double difference=test.u-expected;
+		difference-=(difference>0 ? 0.5 : (difference<0 ? -0.5 : 0));
+		test.z=difference/std::sqrt(variance);
+		test.pValue=std::erfc(std::fabs(test.z)/std::sqrt(2.0));
+		return test;
+	}
+}
+}
+
+#endif
@@ -0,0 +1,186 @@
+/*********************************************************************
+* StreamSocket sends the lines of a dataset stream (see              *
+* dataset_stream.h) to the visualizer over a Unix domain socket.     *
+*                                                                    *
+* The socket is a SOCK_SEQPACKET one: every message is a whole       *
+* number of lines, so a message that cannot be sent is dropped       *
+* without leaving half a line behind. Sending never blocks the       *
+* profiled program, messages are dropped when the reader is slow.    *
+*                                                                    *
+* Version: 1.0                                                       *
+* Date:    16-10-2026                                                *
+* Author:  Dan Machado                                               *
+**********************************************************************/
+#ifndef TIME_PROFILER_STREAM_SOCKET_H
+#define TIME_PROFILER_STREAM_SOCKET_H
+
+#include <cerrno>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+//====================================================================
+
+namespace tprofiler
+{
+
+/*
+ * Socket the visualizer listens on when Live is on:
+ * $XDG_RUNTIME_DIR/time_profiler.sock, or /tmp/time_profiler-<uid>.sock
+ *
+ * */
+inline std::string defaultStreamSocketPath()
+{
+	const char* runtime=std::getenv("XDG_RUNTIME_DIR");
+	if(runtime!=nullptr && runtime[0]!='\0'){
+		return std::string(runtime)+"/time_profiler.sock";
+	}
+	return "/tmp/time_profiler-"+std::to_string(::getuid())+".sock";
+}
+
+//--------------------------------------------------------------------
+
+inline bool makeSocketAddress(const std::string& path, sockaddr_un& address)
+{
+	std::memset(&address, 0, sizeof(address));
+	address.sun_family=AF_UNIX;
+	if(path.empty() || path.size()>=sizeof(address.sun_path)){
+		return false;
+	}
+	std::memcpy(address.sun_path, path.c_str(), path.size());
+	return true;
+}
+
+//--------------------------------------------------------------------
+
+class StreamSocket
+{
+	public:
+		// larger messages are split, at line breaks
+		static constexpr std::size_t MAX_MESSAGE=32*1024;
+
+		// while disconnected, connecting is tried at most this often
+		static constexpr int RETRY_MS=1000;
+
+		StreamSocket()=default;
+		StreamSocket(const StreamSocket&)=delete;
+		StreamSocket& operator=(const StreamSocket&)=delete;
+
+		~StreamSocket()
+		{
+			close();
+		}
+
+		/*
+		 * Send to the socket at path from now on. Not finding a listener
+		 * is not an error: connecting is tried again on later sends.
+		 *
+		 * */
+		void open(const std::string& path)
+		{
+			close();
+			m_path=path;
+			m_nextTry=std::chrono::steady_clock::time_point{};
+		}
+
+		bool isOpen() const
+		{
+			return !m_path.empty();
+		}
+
+		/*
+		 * Connect if not connected.
+		 *
+		 * @return true if a new connection was made: the listener has not
+		 *         seen anything yet
+		 * */
+		bool reconnect()
+		{
+			if(m_fd>=0 || m_path.empty()){
+				return false;
+			}
+			auto now=std::chrono::steady_clock::now();
+			if(now<m_nextTry){
+				return false;
+			}
+			m_nextTry=now+std::chrono::milliseconds(RETRY_MS);
+
+			sockaddr_un address;
+			if(!makeSocketAddress(m_path, address)){
+				return false;
+			}
+			m_fd=::socket(AF_UNIX, SOCK_SEQPACKET|SOCK_NONBLOCK|SOCK_CLOEXEC, 0);
+			if(m_fd<0){
+				return false;
+			}
+			if(::connect(m_fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address))<0){
+				disconnect();
+				return false;
+			}
+			return true;
+		}
+
+		bool connected() const
+		{
+			return m_fd>=0;
+		}
+
+		/*
+		 * Send lines without blocking, split into messages of at most
+		 * MAX_MESSAGE bytes.
+		 *
+		 * @param lines whole lines, each ending in a line break
+		 * @return number of bytes sent from the beginning of lines, the
+		 *         rest was dropped
+		 * */
+		std::size_t send(const std::string& lines)
+		{
+			std::size_t sent=0;
+			while(m_fd>=0 && sent<lines.size()){
+				std::size_t size=lines.size()-sent;
+				if(size>MAX_MESSAGE){
+					std::size_t last=lines.rfind('\n', sent+MAX_MESSAGE-1);
+					size=(last!=std::string::npos && last>=sent ? last+1 : sent+MAX_MESSAGE)-sent;
+				}
+
+				if(::send(m_fd, lines.data()+sent, size, MSG_DONTWAIT|MSG_NOSIGNAL)<0){
+					if(errno!=EAGAIN && errno!=EWOULDBLOCK && errno!=EINTR){
+						disconnect();
+					}
+					break;
+				}
+				sent+=size;
+			}
+			return sent;
+		}
+
+		void close()
+		{
+			disconnect();
+			m_path.clear();
+		}
+
+	private:
+		std::string m_path{};
+		int m_fd{-1};
+		std::chrono::steady_clock::time_point m_nextTry{};
+
+		void disconnect()
+		{
+			if(m_fd>=0){
+				::close(m_fd);
+				m_fd=-1;
+			}
+		}
+};
+
+//====================================================================
+
+}
+
+#endif
@@ -6,20 +6,33 @@
 * (https://github.com/volatilflerovium/time_profiler_visualizer/releases)
 * which will plot those sample in a line chart.                      *
 *                                                                    *
-* Version: 1.0                                                       *
-* Date:    18-10-2025                                                *
+* Version: 1.5                                                       *
+* Date:    16-10-2026                                                *
 * Author:  Dan Machado                                               *
 **********************************************************************/
 #ifndef TIME_PROFILER_H
 #define TIME_PROFILER_H
 
+#include <algorithm>
 #include <fstream>
 #include <cstring>
+#include <cstdio>
+#include <cstdlib>
 #include <ctime>
 #include <chrono>
 #include <iostream>
 #include <iomanip>
+#include <sstream>
 #include <vector>
+#include <string>
+#include <cstdint>
+#include <type_traits>
+
+#include "metrics.h"
+#include "run_metadata.h"
+#include "shared_region.h"
+#include "stream_socket.h"
+#include "trace_export.h"
 
 #ifndef ENABLE_STOPWATCH
 	#ifdef DEBUG
@@ -95,7 +108,7 @@ namespace tprofiler
 
 	inline namespace internal
 	{
-		inline std::string setFileName(const char* outputDir, const char* name, const char* prefix)
+		inline std::string setFileName(const char* outputDir, const char* name, const char* prefix, const char* extension=".js")
 		{
 			std::srand(static_cast<unsigned int>(time(0)));
 			std::string filePath=outputDir;
@@ -110,9 +123,89 @@ namespace tprofiler
 			std::memset(timeString, 0, 32);
 			std::strftime(timeString, 31, "_%y%m%d%H%M%S", std::gmtime(&time));
 			filePath.append(timeString);
-			filePath.append(".js");
+			filePath.append(extension);
 			return filePath;
 		}
+
+		/*
+		 * Write the first size values, padding with zeros if values is shorter.
+		 * 
+		 * */
+		template<typename T>
+		void writeJsonArray(std::ostream& out, const std::vector<T>& values, std::size_t size)
+		{
+			out<<'[';
+			for(std::size_t i=0; i<size; i++){
+				if(i>0){
+					out<<", ";
+				}
+				out<<(i<values.size() ? values[i] : T{});
+			}
+			out<<']';
+		}
+
+		/*
+		 * Mix a "#rrggbb" colour with white, used to derive the colours of
+		 * secondary series (quantiles, references...) from the main one.
+		 * 
+		 * @param amount 0 keeps the colour, 1 is white
+		 * */
+		inline std::string lighterColour(const std::string& colour, double amount)
+		{
+			if(colour.size()!=7 || colour[0]!='#'){
+				return colour;
+			}
+
+			char result[8];
+			result[0]='#';
+			for(int i=0; i<3; i++){
+				int channel=static_cast<int>(std::strtol(colour.substr(1+2*i, 2).c_str(), nullptr, 16));
+				channel=static_cast<int>(channel+(255-channel)*amount);
+				std::snprintf(result+1+2*i, 3, "%02x", channel>255 ? 255 : channel);
+			}
+			return std::string(result, 7);
+		}
+
+		/*
+		 * Append a "key": value pair to a dataset header.
+		 * 
+		 * */
+		inline void appendHeader(std::string& header, const char* key, const std::string& jsonValue)
+		{
+			std::ostringstream entry;
+			writeJsonString(entry, key);
+			entry<<": "<<jsonValue;
+			if(!header.empty()){
+				header.append(", ");
+			}
+			header.append(entry.str());
+		}
+
+		inline void writeDataSetBegin(std::ostream& out)
+		{
+			out<<"{\"dataSet\" : [\n";
+		}
+
+		/*
+		 * @param header comma separated list of "key": value pairs, it can be empty
+		 * @param fields extra top level "key": value pairs, it can be empty
+		 * 
+		 * */
+		inline void writeDataSetEnd(std::ostream& out, const char* timeUnit, const std::string& workUnit, const std::string& header, const std::string& fields="")
+		{
+			out<<"\n], \"timeUnits\": \""<<timeUnit<<"\"";
+			if(!fields.empty()){
+				out<<", "<<fields;
+			}
+			if(!workUnit.empty()){
+				out<<", \"workUnits\": ";
+				writeJsonString(out, workUnit);
+			}
+			if(!header.empty()){
+				out<<", \"header\": {"<<header<<"}";
+			}
+			out<<"}\n";
+		}
 	}
 
 //====================================================================
@@ -151,6 +244,14 @@ namespace tprofiler
  * timeProfiler.takeSample(true); // here we capture the average of the elapsed time
  *                        // of the do_something_else task
  *
+ * example 3)
+ *
+ * do_loop{
+ *    timeProfiler.start()
+ *    handle(request)
+ *    timeProfiler.takeLabelledSample(request.type())  // one series per request type
+ * }
+ *
  *
  * Custom time periods:
  * 
@@ -190,13 +291,16 @@ class TimeProfiler
 		TimeProfiler([[maybe_unused]] const char* name, [[maybe_unused]] const char* colour, [[maybe_unused]] const char* outputDir="")
 		{
 			#ifdef ENABLE_STOPWATCH
+			m_name=name;
+			m_colour=colour;
 			m_buffer.reserve(64);
 			if(std::strlen(outputDir)>0){
 				m_outputFile.open(setFileName(outputDir, name, "line_dataset_"));
 				if(m_outputFile.is_open()){
-					m_outputFile<<"{\"dataSet\" : [\n";
-					m_outputFile<<"{\"name\": "<<"\""<<name<<"\", \"color\": \""<<colour;
-					m_outputFile<<"\", \"data\":[";
+					writeDataSetBegin(m_outputFile);
+					#ifndef TPROFILER_NO_RUN_METADATA
+					appendHeader(m_header, "environment", runMetadata().toJson());
+					#endif
 				}
 			}
 			#endif
@@ -215,6 +319,9 @@ class TimeProfiler
 		{
 			#ifdef ENABLE_STOPWATCH
 			m_isInitialized=true;
+			if(!m_tracePath.empty()){
+				m_traceStart=traceTimestamp();
+			}
 			m_startPoint=std::chrono::high_resolution_clock::now();
 			#endif
 		}
@@ -228,23 +335,45 @@ class TimeProfiler
 		void takeSample([[maybe_unused]] bool print=false)
 		{
 			#ifdef ENABLE_STOPWATCH
-			if(!m_isInitialized && m_count==0){
-				std::cout<<"Timer did not start."<<'\n';
-				return;
+			if(captureSample(print)){
+				setLabel(0);
 			}
+			#endif
+		}
 
-			if(m_count==0){
-				m_partial=elapsedTime();
+		/*
+		 * As takeSample(bool) but tagging the sample with a label, so 
+		 * one profiler can produce one series per label. Labels are
+		 * stored dictionary-encoded: each distinct label is kept once 
+		 * and every sample only carries its code. A name of its own, so
+		 * takeSample(1) keeps meaning takeSample(true).
+		 * 
+		 * @param label an integer (request type, shard, input size...)
+		 * @param print if true, it will print the elapsed time to standard output.
+		 * 
+		 * */
+		template<typename L, typename=std::enable_if_t<std::is_integral<L>::value && !std::is_same<L, bool>::value>>
+		void takeLabelledSample([[maybe_unused]] L label, [[maybe_unused]] bool print=false)
+		{
+			#ifdef ENABLE_STOPWATCH
+			if(captureSample(print)){
+				setLabel(labelCode(std::to_string(label)));
 			}
+			#endif
+		}
 
-			if(print){
-				std::cout<<"Elapsed time:"<<m_partial<<" "<<TimeType<TM>::timeUnit<<"\n";
+		/*
+		 * @param label a string identifying the group of the sample, it
+		 *        is interned on its first use.
+		 * @param print if true, it will print the elapsed time to standard output.
+		 * 
+		 * */
+		void takeLabelledSample([[maybe_unused]] const char* label, [[maybe_unused]] bool print=false)
+		{
+			#ifdef ENABLE_STOPWATCH
+			if(captureSample(print)){
+				setLabel(labelCode(label));
 			}
-			m_buffer.push_back(m_partial);
-			m_total=m_total+m_partial;
-			m_partial=0;
-			m_count=0;			
-			m_isInitialized=false;
 			#endif
 		}
 
@@ -266,6 +395,8 @@ class TimeProfiler
 
 			double averageTime=m_partial/static_cast<double>(m_count);
 			m_buffer.push_back(averageTime);
+			observe(averageTime);
+			setLabel(0);
 			
 			m_count=0;
 
@@ -308,6 +439,166 @@ class TimeProfiler
 			#endif
 		}
 
+		/*
+		 * Take the time elapsed since start() as a batch of iterations 
+		 * and record the time per iteration.
+		 * 
+		 * @param iterations number of repetitions of the task in the batch
+		 * @param print if true, it will print the time per iteration to standard output.
+		 * 
+		 * */
+		void takeBatchSample([[maybe_unused]] long long iterations, [[maybe_unused]] bool print=false)
+		{
+			#ifdef ENABLE_STOPWATCH
+			if(!m_isInitialized){
+				std::cout<<"Timer did not start."<<'\n';
+				return;
+			}
+
+			double elapsed=elapsedTime();
+			double perIteration=elapsed/static_cast<double>(iterations>0 ? iterations : 1);
+			m_buffer.push_back(perIteration);
+			observe(perIteration);
+			recordSpan(elapsed);
+			setLabel(0);
+
+			if(print){
+				std::cout<<"Time per iteration: "<<perIteration<<" "<<TimeType<TM>::timeUnit<<"\n";
+			}
+
+			m_total=m_total+elapsed;
+			m_isInitialized=false;
+			#endif
+		}
+
+		/*
+		 * Remove the samples outside the interval [lower, upper], keeping
+		 * the label and work columns aligned.
+		 * 
+		 * @return number of samples removed
+		 * */
+		std::size_t discardSamples(double lower, double upper);
+
+		const std::vector<double>& samples() const
+		{
+			return m_buffer;
+		}
+
+		const std::string& name() const
+		{
+			return m_name;
+		}
+
+		const std::string& workUnit() const
+		{
+			return m_workUnit;
+		}
+
+		/*
+		 * Add an entry to the header of the dataset file.
+		 * 
+		 * @param key name of the entry
+		 * @param jsonValue the value already formatted as JSON
+		 * */
+		void addHeader([[maybe_unused]] const char* key, [[maybe_unused]] const std::string& jsonValue)
+		{
+			#ifdef ENABLE_STOPWATCH
+			appendHeader(m_header, key, jsonValue);
+			#endif
+		}
+
+		/*
+		 * Also write the samples, as they are taken, to a dataset stream
+		 * (live_dataset_*.tps, see dataset_stream.h) the visualizer can
+		 * follow while the program runs. Samples are written and flushed
+		 * in batches, the dataset file is still written at the end.
+		 * 
+		 * @param outputDir path to the directory of the stream file
+		 * @param batch number of samples written at once
+		 * */
+		void streamTo([[maybe_unused]] const char* outputDir, [[maybe_unused]] std::size_t batch=64);
+
+		/*
+		 * Send the same stream to the visualizer over a Unix domain
+		 * socket, with Live on the chart follows the program as it runs.
+		 * Sending never blocks: the samples of a batch the visualizer is
+		 * not reading fast enough, or not listening, are dropped and
+		 * counted. It reconnects when the visualizer starts listening.
+		 * 
+		 * @param socketPath the socket the visualizer listens on
+		 * @param batch number of samples sent at once
+		 * */
+		void streamToSocket([[maybe_unused]] const std::string& socketPath=defaultStreamSocketPath(), [[maybe_unused]] std::size_t batch=64);
+
+		/*
+		 * Write the samples, in batches, to a ring of a shared-memory
+		 * region many processes write to, instead of a file per process.
+		 * time_profiler_dataset collect drains the region into a single
+		 * dataset, one series per profiler name labelled with the
+		 * process IDs. Every profiler has a ring of its own, written
+		 * without locks; when it is full the samples are dropped and
+		 * counted. Labels of the samples are not kept.
+		 * 
+		 * @param region name of the region, /dev/shm/tprofiler_<region>
+		 * @param batch number of samples written at once
+		 * */
+		void shareTo([[maybe_unused]] const char* region="time_profiler", [[maybe_unused]] std::size_t batch=64);
+
+		/*
+		 * Also record when every sample was taken, and write the samples
+		 * as spans of a trace, on the track of the calling thread, when
+		 * the profiler is flushed: in the Chrome Trace Event JSON format,
+		 * or in the Perfetto protobuf format if path ends in ".pftrace".
+		 * Profilers given the same path, of any thread or process, add
+		 * their spans to the same trace. Spans are timed on the trace
+		 * clock, CLOCK_BOOTTIME: recording them costs start() one more
+		 * clock read.
+		 * 
+		 * @param path trace file, its spans are appended to
+		 * */
+		void traceTo([[maybe_unused]] const std::string& path)
+		{
+			#ifdef ENABLE_STOPWATCH
+			m_tracePath=path;
+			m_traceThread=currentThreadId();
+			#endif
+		}
+
+		/*
+		 * Also count the samples in a histogram exposed to the metrics
+		 * pipeline by a tprofiler::MetricsExporter (metrics_exporter.h),
+		 * shared by the profilers of the same name. Recording a sample
+		 * adds to atomic counters, a scrape never blocks it. The
+		 * histogram is kept by reset(), which can be called from time to
+		 * time for the samples not to pile up in a service always on.
+		 * 
+		 * @param bounds upper bounds of the buckets in seconds, 1μs to 100s
+		 *        by default
+		 * */
+		void exposeMetrics([[maybe_unused]] const std::vector<double>& bounds={})
+		{
+			#ifdef ENABLE_STOPWATCH
+			m_metrics=metricsRegistry().add(m_name, bounds);
+			#endif
+		}
+
+		/*
+		 * Samples streamToSocket() or shareTo() could not deliver. Also
+		 * written to the header of the dataset file, as
+		 * "droppedStreamSamples".
+		 * 
+		 * */
+		std::size_t droppedSamples() const
+		{
+			return m_droppedSamples;
+		}
+
+		/*
+		 * Write the series as an element of the "dataSet" array.
+		 * 
+		 * */
+		void writeSeries(std::ostream& out) const;
+
 		/*
 		 * Reset the current elapsed time, counters.
 		 *  
@@ -320,17 +611,123 @@ class TimeProfiler
 			m_partial=0;
 			m_count=0;
 			m_buffer.clear();
+			m_work.clear();
+			m_labels.clear();
+			m_labelNames.clear();
+			m_spans.clear();
+			m_lastLabel=0;
+			m_streamed=0;
+			m_streamedLabels=0;
+			m_socketLabels=0;
+			m_droppedSamples=0;
 			#endif
 		}	
 
+	protected:
+		std::string m_workUnit{};
+
+		/*
+		 * Stop the clock and push the elapsed time to the buffer.
+		 * 
+		 * @return false if the timer was not started.
+		 * */
+		bool captureSample(bool print)
+		{
+			if(!m_isInitialized && m_count==0){
+				std::cout<<"Timer did not start."<<'\n';
+				return false;
+			}
+
+			bool span=m_count==0;
+			if(span){
+				m_partial=elapsedTime();
+			}
+
+			if(print){
+				std::cout<<"Elapsed time:"<<m_partial<<" "<<TimeType<TM>::timeUnit<<"\n";
+			}
+			m_buffer.push_back(m_partial);
+			observe(m_partial);
+			if(span){
+				recordSpan(m_partial);
+			}
+			m_total=m_total+m_partial;
+			m_partial=0;
+			m_count=0;			
+			m_isInitialized=false;
+			return true;
+		}
+
+		double lastSample() const
+		{
+			return m_buffer.back();
+		}
+
+		/*
+		 * Attach the amount of work done (bytes, items...) to the last
+		 * sample. It is streamed by the setLabel() that follows.
+		 * 
+		 * */
+		void setWork(std::uint64_t work)
+		{
+			m_work.resize(m_buffer.size()-1, 0);
+			m_work.push_back(work);
+		}
+
+		/*
+		 * Tag the last sample. The label column is only kept once a
+		 * labelled sample has been taken, unlabelled samples get code 0.
+		 * 
+		 * */
+		void setLabel(std::uint16_t code)
+		{
+			if(code>0 || !m_labels.empty()){
+				m_labels.resize(m_buffer.size()-1, 0);
+				m_labels.push_back(code);
+			}
+			streamSamples(false);
+		}
+
+		std::uint16_t labelCode(const std::string& label);
+
 	private:
+		std::string m_name{};
+		std::string m_colour{};
+		std::string m_header{};
 		mutable std::vector<double> m_buffer{};
+		std::vector<std::uint64_t> m_work{};
+		std::vector<std::uint16_t> m_labels{};
+		std::vector<std::string> m_labelNames{};
 		std::ofstream m_outputFile{};
+		std::ofstream m_streamFile{};
+		std::size_t m_streamBatch{64};
+		std::size_t m_streamed{0};       // samples already in the stream
+		std::size_t m_streamedLabels{0}; // label names already in the stream
+		std::string m_streamHeader{};
+		StreamSocket m_streamSocket{};
+		SharedSlotWriter m_sharedSlot{};
+		bool m_socketHeader{false};      // the listener has the header
+		std::size_t m_socketLabels{0};   // label names the listener has
+		std::size_t m_droppedSamples{0};
+
+		// time span of each sample, in ns on the trace clock, {0, 0} if
+		// the sample is an average of several
+		struct Span
+		{
+			std::int64_t begin;
+			std::int64_t end;
+		};
+		std::vector<Span> m_spans{};
+		std::string m_tracePath{};
+		int m_traceThread{0};
+		std::int64_t m_traceStart{0};
+		std::shared_ptr<MetricsHistogram> m_metrics{};
 
 		std::chrono::high_resolution_clock::time_point m_startPoint{};
 		double m_total{0};
 		double m_partial{0};
 		long long m_count{0};
+		std::uint16_t m_lastLabel{0};
 		bool m_isInitialized{false};
 
 		typedef std::chrono::duration<double, typename TimeType<TM>::timePeriod > duration;
@@ -341,6 +738,52 @@ class TimeProfiler
 			return elapsed.count();
 		}
 
+
+		/*
+		 * Record the span of the last sample, which started at the last
+		 * start() and took elapsed.
+		 * 
+		 * */
+		void recordSpan(double elapsed)
+		{
+			if(!m_tracePath.empty()){
+				std::int64_t begin=m_traceStart;
+				m_spans.resize(m_buffer.size()-1, Span{0, 0});
+				m_spans.push_back(Span{begin, begin+std::chrono::duration_cast<std::chrono::nanoseconds>(duration(elapsed)).count()});
+			}
+		}
+
+		void writeTrace();
+
+		void observe(double sample)
+		{
+			if(m_metrics){
+				m_metrics->observe(sample*TimeType<TM>::timePeriod::num/TimeType<TM>::timePeriod::den);
+			}
+		}
+
+		/*
+		 * Write the samples not in the stream yet, only once there is a
+		 * whole batch of them unless all is true.
+		 * 
+		 * */
+		void streamSamples(bool all);
+
+		/*
+		 * First line of the stream: a dataset without samples.
+		 * 
+		 * */
+		const std::string& streamHeader();
+
+		void writeStreamLabels(std::ostream& out, std::size_t from) const;
+
+		/*
+		 * Send the header and label names the listener has not seen yet
+		 * and then the sample lines, counting the samples dropped.
+		 * 
+		 * */
+		void sendSamples(const std::string& lines, std::size_t count);
+
 		/*
 		 * Force to dump the dataset. This method is called by the destructor.
 		 *
@@ -351,21 +794,60 @@ class TimeProfiler
 //--------------------------------------------------------------------
 
 template<typename TM>
-void TimeProfiler<TM>::flush()
+void TimeProfiler<TM>::writeSeries([[maybe_unused]] std::ostream& out) const
 {
 	#ifdef ENABLE_STOPWATCH
-	if(m_outputFile.is_open()){
-		bool a=false;
-		for(double data : m_buffer){
-			if(a){
-				m_outputFile<<", ";
+	out<<"{\"name\": ";
+	writeJsonString(out, m_name);
+	out<<", \"color\": ";
+	writeJsonString(out, m_colour);
+	out<<", \"data\":";
+	writeJsonArray(out, m_buffer, m_buffer.size());
+
+	if(!m_workUnit.empty()){
+		out<<", \"work\":";
+		writeJsonArray(out, m_work, m_buffer.size());
+	}
+
+	if(!m_labels.empty()){
+		out<<", \"labels\":";
+		writeJsonArray(out, m_labels, m_buffer.size());
+		out<<", \"labelNames\":[";
+		for(std::size_t i=0; i<m_labelNames.size(); i++){
+			if(i>0){
+				out<<", ";
 			}
-			m_outputFile<<data;
-			a=true;
+			writeJsonString(out, m_labelNames[i]);
 		}
-		m_outputFile<<"]}\n";
+		out<<"]";
+	}
+	out<<"}";
+	#endif
+}
+
+//--------------------------------------------------------------------
+
+template<typename TM>
+void TimeProfiler<TM>::flush()
+{
+	#ifdef ENABLE_STOPWATCH
+	streamSamples(true);
+	if(m_streamFile.is_open()){
+		m_streamFile.close();
+	}
+	if(m_streamSocket.isOpen() || m_sharedSlot.isOpen()){
+		m_streamSocket.close();
+		m_sharedSlot.close();
+		appendHeader(m_header, "droppedStreamSamples", std::to_string(m_droppedSamples));
+	}
 
-		m_outputFile<<"], \"timeUnits\": \""<<TimeType<TM>::timeUnit<<"\"}\n";
+	if(!m_tracePath.empty()){
+		writeTrace();
+	}
+
+	if(m_outputFile.is_open()){
+		writeSeries(m_outputFile);
+		writeDataSetEnd(m_outputFile, TimeType<TM>::timeUnit, m_workUnit, m_header);
 		m_outputFile.flush();
 		m_outputFile.close();
 	}
@@ -374,6 +856,524 @@ void TimeProfiler<TM>::flush()
 	#endif
 }
 
+//--------------------------------------------------------------------
+
+template<typename TM>
+void TimeProfiler<TM>::writeTrace()
+{
+	TraceWriter writer(traceFormat(m_tracePath), m_name, static_cast<int>(::getpid()), m_traceThread);
+	const std::string unlabelled;
+	for(std::size_t i=0; i<m_spans.size() && i<m_buffer.size(); i++){
+		const Span& span=m_spans[i];
+		if(span.begin==0 && span.end==0){
+			continue;
+		}
+		bool labelled=i<m_labels.size() && m_labels[i]>0;
+		double work=m_workUnit.empty() ? -1 : (i<m_work.size() ? static_cast<double>(m_work[i]) : 0);
+		writer.span(span.begin, span.end, labelled ? m_labelNames[m_labels[i]] : unlabelled, work);
+	}
+
+	if(!writer.append(m_tracePath)){
+		std::cout<<"Cannot write the trace "<<m_tracePath<<'\n';
+	}
+}
+
+//--------------------------------------------------------------------
+
+template<typename TM>
+std::size_t TimeProfiler<TM>::discardSamples([[maybe_unused]] double lower, [[maybe_unused]] double upper)
+{
+	std::size_t j=0;
+	#ifdef ENABLE_STOPWATCH
+	// samples already streamed cannot be taken back
+	streamSamples(true);
+	m_work.resize(m_work.empty() ? 0 : m_buffer.size(), 0);
+	m_labels.resize(m_labels.empty() ? 0 : m_buffer.size(), 0);
+	m_spans.resize(m_spans.empty() ? 0 : m_buffer.size(), Span{0, 0});
+	for(std::size_t i=0; i<m_buffer.size(); i++){
+		if(m_buffer[i]<lower || m_buffer[i]>upper){
+			m_total=m_total-m_buffer[i];
+			continue;
+		}
+		m_buffer[j]=m_buffer[i];
+		if(!m_work.empty()){
+			m_work[j]=m_work[i];
+		}
+		if(!m_labels.empty()){
+			m_labels[j]=m_labels[i];
+		}
+		if(!m_spans.empty()){
+			m_spans[j]=m_spans[i];
+		}
+		j++;
+	}
+
+	std::size_t removed=m_buffer.size()-j;
+	m_buffer.resize(j);
+	m_streamed=j;
+	m_work.resize(m_work.empty() ? 0 : j);
+	m_labels.resize(m_labels.empty() ? 0 : j);
+	m_spans.resize(m_spans.empty() ? 0 : j);
+	return removed;
+	#else
+	return j;
+	#endif
+}
+
+//--------------------------------------------------------------------
+
+template<typename TM>
+void TimeProfiler<TM>::streamTo([[maybe_unused]] const char* outputDir, [[maybe_unused]] std::size_t batch)
+{
+	#ifdef ENABLE_STOPWATCH
+	m_streamFile.open(setFileName(outputDir, m_name.c_str(), "live_dataset_", ".tps"));
+	if(!m_streamFile.is_open()){
+		return;
+	}
+	m_streamBatch=batch>0 ? batch : 1;
+	m_streamFile<<streamHeader();
+	streamSamples(true);
+	#endif
+}
+
+//--------------------------------------------------------------------
+
+template<typename TM>
+void TimeProfiler<TM>::streamToSocket([[maybe_unused]] const std::string& socketPath, [[maybe_unused]] std::size_t batch)
+{
+	#ifdef ENABLE_STOPWATCH
+	m_streamSocket.open(socketPath);
+	m_streamBatch=batch>0 ? batch : 1;
+	m_socketHeader=false;
+	m_socketLabels=0;
+	streamSamples(true);
+	#endif
+}
+
+//--------------------------------------------------------------------
+
+template<typename TM>
+void TimeProfiler<TM>::shareTo([[maybe_unused]] const char* region, [[maybe_unused]] std::size_t batch)
+{
+	#ifdef ENABLE_STOPWATCH
+	try{
+		m_sharedSlot.open(region, m_name, m_colour, TimeType<TM>::timeUnit, m_workUnit);
+	}
+	catch(const std::exception& e){
+		std::cout<<"Samples not shared: "<<e.what()<<'\n';
+		return;
+	}
+	m_streamBatch=batch>0 ? batch : 1;
+	streamSamples(true);
+	#endif
+}
+
+//--------------------------------------------------------------------
+
+template<typename TM>
+void TimeProfiler<TM>::streamSamples([[maybe_unused]] bool all)
+{
+	#ifdef ENABLE_STOPWATCH
+	if((!m_streamFile.is_open() && !m_streamSocket.isOpen() && !m_sharedSlot.isOpen()) || m_buffer.size()<m_streamed+(all ? 1 : m_streamBatch)){
+		return;
+	}
+
+	if(m_sharedSlot.isOpen()){
+		for(std::size_t i=m_streamed; i<m_buffer.size(); i++){
+			double work=i<m_work.size() ? static_cast<double>(m_work[i]) : 0;
+			if(!m_sharedSlot.push(m_buffer[i], work)){
+				m_droppedSamples++;
+			}
+		}
+		m_sharedSlot.publish();
+		if(!m_streamFile.is_open() && !m_streamSocket.isOpen()){
+			m_streamed=m_buffer.size();
+			return;
+		}
+	}
+
+	std::ostringstream out;
+	for(std::size_t i=m_streamed; i<m_buffer.size(); i++){
+		out<<m_buffer[i];
+		if(!m_workUnit.empty()){
+			out<<' '<<(i<m_work.size() ? m_work[i] : 0);
+		}
+		if(i<m_labels.size() && m_labels[i]>0){
+			out<<" #"<<m_labels[i];
+		}
+		out<<'\n';
+	}
+	std::string lines=out.str();
+
+	if(m_streamFile.is_open()){
+		writeStreamLabels(m_streamFile, m_streamedLabels);
+		m_streamedLabels=m_labelNames.size();
+		m_streamFile<<lines;
+		m_streamFile.flush();
+	}
+	if(m_streamSocket.isOpen()){
+		sendSamples(lines, m_buffer.size()-m_streamed);
+	}
+	m_streamed=m_buffer.size();
+	#endif
+}
+
+//--------------------------------------------------------------------
+
+template<typename TM>
+const std::string& TimeProfiler<TM>::streamHeader()
+{
+	if(m_streamHeader.empty()){
+		std::ostringstream header;
+		header<<"{\"stream\": 1, \"dataSet\": [{\"name\": ";
+		writeJsonString(header, m_name);
+		header<<", \"color\": ";
+		writeJsonString(header, m_colour);
+		header<<"}";
+		writeDataSetEnd(header, TimeType<TM>::timeUnit, m_workUnit, m_header);
+		m_streamHeader=header.str();
+		m_streamHeader.pop_back();
+		for(char& c : m_streamHeader){
+			if(c=='\n'){
+				c=' ';
+			}
+		}
+		m_streamHeader.push_back('\n');
+	}
+	return m_streamHeader;
+}
+
+//--------------------------------------------------------------------
+
+template<typename TM>
+void TimeProfiler<TM>::writeStreamLabels(std::ostream& out, std::size_t from) const
+{
+	for(std::size_t i=from; i<m_labelNames.size(); i++){
+		out<<'#'<<i<<' ';
+		writeJsonString(out, m_labelNames[i]);
+		out<<'\n';
+	}
+}
+
+//--------------------------------------------------------------------
+
+template<typename TM>
+void TimeProfiler<TM>::sendSamples(const std::string& lines, std::size_t count)
+{
+	if(m_streamSocket.reconnect()){
+		m_socketHeader=false;
+		m_socketLabels=0;
+	}
+	if(!m_streamSocket.connected()){
+		m_droppedSamples+=count;
+		return;
+	}
+
+	std::ostringstream out;
+	if(!m_socketHeader){
+		out<<streamHeader();
+	}
+	writeStreamLabels(out, m_socketLabels);
+	out<<lines;
+	std::string message=out.str();
+
+	// lines are sent in order, the first ones sent are the header and
+	// the label names
+	std::size_t sent=m_streamSocket.send(message);
+	std::size_t received=static_cast<std::size_t>(std::count(message.begin(), message.begin()+sent, '\n'));
+	if(!m_socketHeader && received>0){
+		m_socketHeader=true;
+		received--;
+	}
+	std::size_t labels=std::min(received, m_labelNames.size()-std::min(m_socketLabels, m_labelNames.size()));
+	m_socketLabels+=labels;
+	m_droppedSamples+=count-(received-labels);
+}
+
+//--------------------------------------------------------------------
+
+template<typename TM>
+std::uint16_t TimeProfiler<TM>::labelCode(const std::string& label)
+{
+	if(m_labelNames.empty()){
+		m_labelNames.emplace_back(""); // code 0: unlabelled samples
+	}
+
+	if(m_labelNames[m_lastLabel]==label){
+		return m_lastLabel;
+	}
+
+	for(std::size_t i=0; i<m_labelNames.size(); i++){
+		if(m_labelNames[i]==label){
+			m_lastLabel=static_cast<std::uint16_t>(i);
+			return m_lastLabel;
+		}
+	}
+
+	if(m_labelNames.size()>UINT16_MAX){
+		std::cout<<"Too many labels, sample recorded as unlabelled.\n";
+		return 0;
+	}
+
+	m_labelNames.push_back(label);
+	m_lastLabel=static_cast<std::uint16_t>(m_labelNames.size()-1);
+	return m_lastLabel;
+}
+
+//====================================================================
+
+/*
+ * ThroughputProfiler records, next to each elapsed time, the amount of
+ * work done in that interval (bytes, items, records...). The visualizer
+ * plots the rate, work per TimeType unit, instead of the raw elapsed time.
+ * 
+ * Example:
+ * 
+ * tprofiler::ThroughputProfiler<std::chrono::microseconds> ingest("ingest", "#3cb44b", "bytes", "/tmp");
+ * 
+ * ingest.start()
+ * std::size_t n=readChunk(buffer)
+ * ingest.takeSample(n)     // n bytes in the elapsed time
+ * ingest.takeSample(n, "compressed")
+ * 
+ * */
+template<typename TM>
+class ThroughputProfiler : public TimeProfiler<TM>
+{
+	public:
+		/*
+		 * Constructor
+		 * 
+		 * @param name a string to identify the dataset
+		 * @param colour the colour for the dataset
+		 * @param workUnit the unit of the work count (e.g. "bytes", "items")
+		 * @param outputDir path to the directory where the js with the dataset
+		 *        file will be created.
+		 * */
+		ThroughputProfiler(const char* name, const char* colour, const char* workUnit="items", const char* outputDir="")
+		: TimeProfiler<TM>(name, colour, outputDir)
+		{
+			this->m_workUnit=workUnit;
+		}
+
+		/*
+		 * Stop the clock (or take the time accumulated with pause()) and 
+		 * record it with the work done in that time.
+		 * 
+		 * @param work amount of work processed in the interval
+		 * @param print if true, it will print the rate to standard output.
+		 * 
+		 * */
+		template<typename W, typename=std::enable_if_t<std::is_integral<W>::value && !std::is_same<W, bool>::value>>
+		void takeSample([[maybe_unused]] W work, [[maybe_unused]] bool print=false)
+		{
+			#ifdef ENABLE_STOPWATCH
+			takeWorkSample(static_cast<std::uint64_t>(work), nullptr, print);
+			#endif
+		}
+
+		/*
+		 * As takeSample(work, print), tagging the sample with a label.
+		 * 
+		 * @param label a string identifying the group of the sample
+		 * 
+		 * */
+		template<typename W, typename=std::enable_if_t<std::is_integral<W>::value && !std::is_same<W, bool>::value>>
+		void takeSample([[maybe_unused]] W work, [[maybe_unused]] const char* label, [[maybe_unused]] bool print=false)
+		{
+			#ifdef ENABLE_STOPWATCH
+			takeWorkSample(static_cast<std::uint64_t>(work), label, print);
+			#endif
+		}
+
+		// every sample needs its work: takeSample(true) must not record 1
+		void takeSample(bool print=false)=delete;
+		template<typename L>
+		void takeLabelledSample(L label, bool print=false)=delete;
+
+	private:
+		void takeWorkSample(std::uint64_t work, const char* label, bool print)
+		{
+			if(this->captureSample(false)){
+				this->setWork(work);
+				this->setLabel(label!=nullptr ? this->labelCode(label) : 0);
+				if(print){
+					double elapsed=this->lastSample();
+					std::cout<<"Throughput: "<<(elapsed>0 ? work/elapsed : 0)<<" "<<this->m_workUnit<<"/"<<TimeType<TM>::timeUnit<<"\n";
+				}
+			}
+		}
+};
+
+//====================================================================
+
+/*
+ * DataSetWriter puts the series of several profilers into a single 
+ * dataset file, so they can be loaded at once in the visualizer.
+ * 
+ * Example:
+ * 
+ * tprofiler::DataSetWriter<std::chrono::microseconds> writer("/tmp", "comparison");
+ * writer.addSeries(profilerA);
+ * writer.addSeries(profilerB);
+ * writer.addHeader("note", "\"candidate build\"");
+ * writer.close();
+ * 
+ * */
+template<typename TM>
+class DataSetWriter
+{
+	public:
+		/*
+		 * Constructor
+		 * 
+		 * @param outputDir path to the directory where the js file will be created
+		 * @param name a string to identify the file
+		 * */
+		DataSetWriter([[maybe_unused]] const char* outputDir, [[maybe_unused]] const char* name)
+		{
+			#ifdef ENABLE_STOPWATCH
+			m_outputFile.open(setFileName(outputDir, name, "line_dataset_"));
+			if(m_outputFile.is_open()){
+				writeDataSetBegin(m_outputFile);
+				#ifndef TPROFILER_NO_RUN_METADATA
+				appendHeader(m_header, "environment", runMetadata().toJson());
+				#endif
+			}
+			#endif
+		}
+
+		~DataSetWriter()
+		{
+			close();
+		}
+
+		bool isOpen() const
+		{
+			return m_outputFile.is_open();
+		}
+
+		void addSeries([[maybe_unused]] const TimeProfiler<TM>& profiler)
+		{
+			#ifdef ENABLE_STOPWATCH
+			if(m_outputFile.is_open()){
+				if(m_seriesCount>0){
+					m_outputFile<<",\n";
+				}
+				profiler.writeSeries(m_outputFile);
+				if(m_workUnit.empty()){
+					m_workUnit=profiler.workUnit();
+				}
+				m_seriesCount++;
+			}
+			#endif
+		}
+
+		/*
+		 * Add a series of values derived from samples (quantiles, fitted
+		 * curves...) rather than recorded by a profiler.
+		 * 
+		 * */
+		void addSeries([[maybe_unused]] const char* name, [[maybe_unused]] const char* colour, [[maybe_unused]] const std::vector<double>& data)
+		{
+			#ifdef ENABLE_STOPWATCH
+			if(m_outputFile.is_open()){
+				if(m_seriesCount>0){
+					m_outputFile<<",\n";
+				}
+				m_outputFile<<"{\"name\": ";
+				writeJsonString(m_outputFile, name);
+				m_outputFile<<", \"color\": ";
+				writeJsonString(m_outputFile, colour);
+				m_outputFile<<", \"data\":";
+				writeJsonArray(m_outputFile, data, data.size());
+				m_outputFile<<"}";
+				m_seriesCount++;
+			}
+			#endif
+		}
+
+		/*
+		 * Replace the sample number on the x-axis by the given values,
+		 * one per data point (input sizes, thread counts...).
+		 * 
+		 * @param title title of the x-axis
+		 * @param values x coordinate of each data point
+		 * @param labels optional text shown for each point instead of the value
+		 * */
+		void setXAxis([[maybe_unused]] const char* title, [[maybe_unused]] const std::vector<double>& values, [[maybe_unused]] const std::vector<std::string>& labels={})
+		{
+			#ifdef ENABLE_STOPWATCH
+			std::ostringstream fields;
+			fields<<std::setprecision(15);
+			writeJsonString(fields, title);
+			appendHeader(m_fields, "xTitle", fields.str());
+
+			fields.str("");
+			writeJsonArray(fields, values, values.size());
+			appendHeader(m_fields, "x", fields.str());
+
+			if(!labels.empty()){
+				fields.str("");
+				fields<<"[";
+				for(std::size_t i=0; i<labels.size(); i++){
+					if(i>0){
+						fields<<", ";
+					}
+					writeJsonString(fields, labels[i]);
+				}
+				fields<<"]";
+				appendHeader(m_fields, "xLabels", fields.str());
+			}
+			#endif
+		}
+
+		/*
+		 * Replace the default "Elapsed time (unit)" title of the y-axis,
+		 * for datasets of ratios, counts...
+		 * 
+		 * */
+		void setYTitle([[maybe_unused]] const char* title)
+		{
+			#ifdef ENABLE_STOPWATCH
+			std::ostringstream field;
+			writeJsonString(field, title);
+			appendHeader(m_fields, "yTitle", field.str());
+			#endif
+		}
+
+		/*
+		 * Add an entry to the dataset header.
+		 * 
+		 * @param key name of the entry
+		 * @param jsonValue the value already formatted as JSON
+		 * */
+		void addHeader([[maybe_unused]] const char* key, [[maybe_unused]] const std::string& jsonValue)
+		{
+			#ifdef ENABLE_STOPWATCH
+			appendHeader(m_header, key, jsonValue);
+			#endif
+		}
+
+		void close()
+		{
+			#ifdef ENABLE_STOPWATCH
+			if(m_outputFile.is_open()){
+				writeDataSetEnd(m_outputFile, TimeType<TM>::timeUnit, m_workUnit, m_header, m_fields);
+				m_outputFile.flush();
+				m_outputFile.close();
+			}
+			#endif
+		}
+
+	private:
+		std::ofstream m_outputFile{};
+		std::string m_header{};
+		std::string m_fields{};
+		std::string m_workUnit{};
+		std::size_t m_seriesCount{0};
+};
+
 //====================================================================
 
 }
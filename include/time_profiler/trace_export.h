@@ -0,0 +1,379 @@
+/*********************************************************************
+* Export of the samples of a profiler as spans of a trace, for the   *
+* trace viewers: the Chrome Trace Event JSON format (chrome://tracing,*
+* Perfetto UI) or the Perfetto protobuf trace format.                *
+*                                                                    *
+* Both formats can be appended to: a JSON trace is an array whose    *
+* closing bracket is optional, a protobuf trace a sequence of        *
+* packets. Every profiler appends its spans to the trace with a      *
+* single write when it is flushed, so several profilers, of several  *
+* threads or processes, can share a trace file.                      *
+*                                                                    *
+* Version: 1.1                                                       *
+* Date:    16-10-2026                                                *
+* Author:  Dan Machado                                               *
+**********************************************************************/
+#ifndef TIME_PROFILER_TRACE_EXPORT_H
+#define TIME_PROFILER_TRACE_EXPORT_H
+
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <initializer_list>
+#include <ctime>
+#include <string>
+
+#include <fcntl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+//====================================================================
+
+namespace tprofiler
+{
+
+enum class TraceFormat
+{
+	Json,
+	Protobuf
+};
+
+/*
+ * Protobuf for names ending in ".pftrace", ".perfetto-trace" or ".pb",
+ * JSON otherwise.
+ *
+ * */
+inline TraceFormat traceFormat(const std::string& path)
+{
+	for(const char* extension : {".pftrace", ".perfetto-trace", ".pb"}){
+		std::string ending(extension);
+		if(path.size()>ending.size() && path.compare(path.size()-ending.size(), ending.size(), ending)==0){
+			return TraceFormat::Protobuf;
+		}
+	}
+	return TraceFormat::Json;
+}
+
+inline int currentThreadId()
+{
+	return static_cast<int>(::syscall(SYS_gettid));
+}
+
+/*
+ * Nanoseconds on CLOCK_BOOTTIME, the clock Perfetto traces default to,
+ * so spans line up with the other traces of the system.
+ *
+ * */
+inline std::int64_t traceTimestamp()
+{
+	timespec now;
+	::clock_gettime(CLOCK_BOOTTIME, &now);
+	return static_cast<std::int64_t>(now.tv_sec)*1000000000ll+now.tv_nsec;
+}
+
+//--------------------------------------------------------------------
+
+/*
+ * Spans of one profiler, on the track of the thread it ran on.
+ * Timestamps are in nanoseconds, from traceTimestamp().
+ *
+ * */
+class TraceWriter
+{
+	public:
+		TraceWriter(TraceFormat format, const std::string& name, int pid, int tid)
+		: m_format(format)
+		, m_name(name)
+		, m_pid(pid)
+		, m_tid(tid)
+		{
+			if(m_format==TraceFormat::Protobuf){
+				describeTracks();
+			}
+		}
+
+		/*
+		 * @param label empty if the sample has none
+		 * @param work negative if the sample has none
+		 * */
+		void span(std::int64_t begin, std::int64_t end, const std::string& label, double work)
+		{
+			if(m_format==TraceFormat::Json){
+				jsonSpan(begin, end, label, work);
+			}
+			else{
+				protobufSpan(begin, end, label, work);
+			}
+		}
+
+		const std::string& data() const
+		{
+			return m_data;
+		}
+
+		/*
+		 * Append the spans to the trace at path with a single write. A
+		 * JSON trace is created with its opening bracket already in it.
+		 *
+		 * @return false if the trace cannot be written
+		 * */
+		bool append(const std::string& path) const
+		{
+			if(m_format==TraceFormat::Json && !createJsonTrace(path)){
+				return false;
+			}
+			int fd=::open(path.c_str(), O_WRONLY|O_APPEND|O_CREAT|O_CLOEXEC, 0644);
+			if(fd<0){
+				return false;
+			}
+			bool written=writeAll(fd, m_data);
+			::close(fd);
+			return written;
+		}
+
+	private:
+		TraceFormat m_format;
+		std::string m_name;
+		int m_pid;
+		int m_tid;
+		std::string m_data{};
+		std::uint64_t m_trackUuid{0};
+
+		// Perfetto field numbers
+		enum : std::uint32_t
+		{
+			TRACE_PACKET=1,
+			PACKET_TIMESTAMP=8,
+			PACKET_SEQUENCE_ID=10,
+			PACKET_TRACK_EVENT=11,
+			PACKET_SEQUENCE_FLAGS=13,
+			PACKET_TIMESTAMP_CLOCK_ID=58,
+			PACKET_TRACK_DESCRIPTOR=60,
+			TRACK_UUID=1,
+			TRACK_NAME=2,
+			TRACK_PARENT_UUID=5,
+			TRACK_THREAD=4,
+			THREAD_PID=1,
+			THREAD_TID=2,
+			EVENT_DEBUG_ANNOTATIONS=4,
+			EVENT_TYPE=9,
+			EVENT_TRACK_UUID=11,
+			EVENT_NAME=23,
+			ANNOTATION_DOUBLE_VALUE=5,
+			ANNOTATION_STRING_VALUE=6,
+			ANNOTATION_NAME=10,
+			SLICE_BEGIN=1,
+			SLICE_END=2,
+			INCREMENTAL_STATE_CLEARED=1,
+			CLOCK_BOOTTIME_ID=6
+		};
+
+		static bool writeAll(int fd, const std::string& data)
+		{
+			const char* p=data.data();
+			std::size_t size=data.size();
+			while(size>0){
+				ssize_t written=::write(fd, p, size);
+				if(written<0 && errno==EINTR){
+					continue;
+				}
+				if(written<=0){
+					break;
+				}
+				p+=written;
+				size-=static_cast<std::size_t>(written);
+			}
+			return size==0;
+		}
+
+		/*
+		 * The bracket is written to a file of this thread, which is then
+		 * linked to path: nobody can append to the trace before it, and
+		 * if another process created the trace first, its file is kept.
+		 *
+		 * */
+		static bool createJsonTrace(const std::string& path)
+		{
+			if(::access(path.c_str(), F_OK)==0){
+				return true;
+			}
+			std::string temporary=path+"."+std::to_string(::getpid())+"."+std::to_string(currentThreadId());
+			int fd=::open(temporary.c_str(), O_WRONLY|O_CREAT|O_TRUNC|O_CLOEXEC, 0644);
+			if(fd<0){
+				return false;
+			}
+			bool created=writeAll(fd, "[\n");
+			::close(fd);
+			created=created && (::link(temporary.c_str(), path.c_str())==0 || errno==EEXIST);
+			::unlink(temporary.c_str());
+			return created;
+		}
+
+		void jsonSpan(std::int64_t begin, std::int64_t end, const std::string& label, double work)
+		{
+			char numbers[96];
+			m_data+="{\"name\": ";
+			jsonString(m_name);
+			std::snprintf(numbers, sizeof(numbers), ", \"cat\": \"tprofiler\", \"ph\": \"X\", \"ts\": %lld.%03lld, \"dur\": %lld.%03lld",
+				static_cast<long long>(begin/1000), static_cast<long long>(begin%1000),
+				static_cast<long long>((end-begin)/1000), static_cast<long long>((end-begin)%1000));
+			m_data+=numbers;
+			std::snprintf(numbers, sizeof(numbers), ", \"pid\": %d, \"tid\": %d", m_pid, m_tid);
+			m_data+=numbers;
+			if(!label.empty() || work>=0){
+				m_data+=", \"args\": {";
+				if(!label.empty()){
+					m_data+="\"label\": ";
+					jsonString(label);
+				}
+				if(work>=0){
+					std::snprintf(numbers, sizeof(numbers), "%s\"work\": %.17g", label.empty() ? "" : ", ", work);
+					m_data+=numbers;
+				}
+				m_data+="}";
+			}
+			m_data+="},\n";
+		}
+
+		void jsonString(const std::string& str)
+		{
+			m_data+='"';
+			for(char c : str){
+				if(c=='"' || c=='\\'){
+					m_data+='\\';
+					m_data+=c;
+				}
+				else if(static_cast<unsigned char>(c)<0x20){
+					m_data+=' ';
+				}
+				else{
+					m_data+=c;
+				}
+			}
+			m_data+='"';
+		}
+
+		/*
+		 * A track for the thread and one for the profiler under it, so
+		 * the spans of profilers overlapping on a thread are not mixed.
+		 *
+		 * */
+		void describeTracks()
+		{
+			std::uint64_t threadUuid=hash(hash(0xcbf29ce484222325ull, &m_pid, sizeof(m_pid)), &m_tid, sizeof(m_tid));
+			m_trackUuid=hash(threadUuid, m_name.data(), m_name.size());
+
+			std::string thread;
+			varintField(thread, THREAD_PID, static_cast<std::uint64_t>(m_pid));
+			varintField(thread, THREAD_TID, static_cast<std::uint64_t>(m_tid));
+			std::string track;
+			varintField(track, TRACK_UUID, threadUuid);
+			bytesField(track, TRACK_THREAD, thread);
+			std::string packet;
+			bytesField(packet, PACKET_TRACK_DESCRIPTOR, track);
+			varintField(packet, PACKET_SEQUENCE_ID, sequenceId());
+			varintField(packet, PACKET_SEQUENCE_FLAGS, INCREMENTAL_STATE_CLEARED);
+			bytesField(m_data, TRACE_PACKET, packet);
+
+			track.clear();
+			varintField(track, TRACK_UUID, m_trackUuid);
+			varintField(track, TRACK_PARENT_UUID, threadUuid);
+			bytesField(track, TRACK_NAME, m_name);
+			packet.clear();
+			bytesField(packet, PACKET_TRACK_DESCRIPTOR, track);
+			varintField(packet, PACKET_SEQUENCE_ID, sequenceId());
+			bytesField(m_data, TRACE_PACKET, packet);
+		}
+
+		void protobufSpan(std::int64_t begin, std::int64_t end, const std::string& label, double work)
+		{
+			std::string annotations;
+			if(!label.empty()){
+				std::string annotation;
+				bytesField(annotation, ANNOTATION_NAME, "label");
+				bytesField(annotation, ANNOTATION_STRING_VALUE, label);
+				bytesField(annotations, EVENT_DEBUG_ANNOTATIONS, annotation);
+			}
+			if(work>=0){
+				std::string annotation;
+				bytesField(annotation, ANNOTATION_NAME, "work");
+				fixed64Field(annotation, ANNOTATION_DOUBLE_VALUE, work);
+				bytesField(annotations, EVENT_DEBUG_ANNOTATIONS, annotation);
+			}
+
+			std::string event;
+			varintField(event, EVENT_TYPE, SLICE_BEGIN);
+			varintField(event, EVENT_TRACK_UUID, m_trackUuid);
+			bytesField(event, EVENT_NAME, m_name);
+			event+=annotations;
+			trackEvent(begin, event);
+
+			event.clear();
+			varintField(event, EVENT_TYPE, SLICE_END);
+			varintField(event, EVENT_TRACK_UUID, m_trackUuid);
+			trackEvent(end, event);
+		}
+
+		void trackEvent(std::int64_t timestamp, const std::string& event)
+		{
+			std::string packet;
+			varintField(packet, PACKET_TIMESTAMP, static_cast<std::uint64_t>(timestamp));
+			varintField(packet, PACKET_TIMESTAMP_CLOCK_ID, CLOCK_BOOTTIME_ID);
+			bytesField(packet, PACKET_TRACK_EVENT, event);
+			varintField(packet, PACKET_SEQUENCE_ID, sequenceId());
+			bytesField(m_data, TRACE_PACKET, packet);
+		}
+
+		std::uint32_t sequenceId() const
+		{
+			return static_cast<std::uint32_t>(m_trackUuid>>33)|1;
+		}
+
+		static std::uint64_t hash(std::uint64_t seed, const void* data, std::size_t size)
+		{
+			const unsigned char* bytes=static_cast<const unsigned char*>(data);
+			for(std::size_t i=0; i<size; i++){
+				seed=(seed^bytes[i])*0x100000001b3ull;
+			}
+			return seed;
+		}
+
+		static void varint(std::string& out, std::uint64_t value)
+		{
+			while(value>=0x80){
+				out+=static_cast<char>((value&0x7f)|0x80);
+				value>>=7;
+			}
+			out+=static_cast<char>(value);
+		}
+
+		static void varintField(std::string& out, std::uint32_t field, std::uint64_t value)
+		{
+			varint(out, field<<3);
+			varint(out, value);
+		}
+
+		static void fixed64Field(std::string& out, std::uint32_t field, double value)
+		{
+			varint(out, (field<<3)|1);
+			std::uint64_t bits;
+			std::memcpy(&bits, &value, sizeof(bits));
+			for(int i=0; i<8; i++){
+				out+=static_cast<char>(bits>>(8*i));
+			}
+		}
+
+		static void bytesField(std::string& out, std::uint32_t field, const std::string& value)
+		{
+			varint(out, (field<<3)|2);
+			varint(out, value.size());
+			out+=value;
+		}
+};
+
+//====================================================================
+
+}
+
+#endif